@@ -0,0 +1,139 @@
+#include "DraggableBezierCurve.h"
+
+#include <imgui.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <string>
+
+/**
+ * @file main.cpp
+ * Файл, содержащий сравнение способов построения обводки кривых без окна и графического контекста.
+ * Кривые читаются из файла в формате примера, по одной на строку, или строятся по случайным точкам.
+ * Числа вершин, индексов и время имеют смысл только при сборке с настоящим ImGui, который разбивает кривые и строит
+ * ломаные; сравнение способов обводки на нём ещё не проводилось.
+ * @brief Замер обводки кривых
+ */
+
+/**
+ * @brief Результат замера обводки.
+ */
+struct StrokeStats {
+    int vertices = 0; ///< Число вершин, добавленных в список отрисовки за кадр.
+    int indices = 0; ///< Число индексов, добавленных в список отрисовки за кадр.
+    double milliseconds = 0.0; ///< Среднее время построения обводки всех кривых за кадр.
+};
+
+/**
+ * @brief Функция строит обводку кривых в нескольких кадрах и замеряет её стоимость.
+ * @param bezierCurves Вектор кривых.
+ * @param batched Способ построения обводки, передаваемый в SetBatchedStroke().
+ * @param frames Число кадров.
+ * @return Результат замера.
+ */
+StrokeStats MeasureStroke(std::vector<ImGui::DraggableBezierCurve>& bezierCurves, bool batched, int frames) {
+    StrokeStats stats;
+    ImGui::ZoneMapper zones;
+    zones.Begin(ImVec2(0, 0), ImGui::GetIO().DisplaySize);
+
+    for (auto& curve : bezierCurves) curve.SetBatchedStroke(batched);
+
+    for (int frame = 0; frame < frames; frame++) {
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0, 0));
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+        ImGui::Begin("Stroke Benchmark");
+
+        ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        int vertices = draw_list->VtxBuffer.Size;
+        int indices = draw_list->IdxBuffer.Size;
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto& curve : bezierCurves) curve.Draw(draw_list, zones);
+        auto finish = std::chrono::steady_clock::now();
+
+        stats.vertices = draw_list->VtxBuffer.Size - vertices;
+        stats.indices = draw_list->IdxBuffer.Size - indices;
+        stats.milliseconds += std::chrono::duration<double, std::milli>(finish - start).count() / frames;
+
+        ImGui::End();
+        ImGui::EndFrame();
+    }
+
+    zones.End();
+    return stats;
+}
+
+/**
+ * @brief Функция строит кривые по случайным точкам так же, как их сохраняет пример, и разбирает их через Deserialize().
+ * @param count Число кривых.
+ * @param points Число точек на кривую.
+ * @param size Размер области, в которой лежат точки.
+ * @return Вектор кривых, каждая вторая замкнута.
+ */
+std::vector<ImGui::DraggableBezierCurve> RandomCurves(int count, int points, const ImVec2& size) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> coordinate(0.0f, 1.0f);
+
+    std::vector<ImGui::DraggableBezierCurve> bezierCurves;
+    for (int c = 0; c < count; c++) {
+        ImGui::BezierGeometry::CurveData data;
+        data.closed = c % 2 == 1;
+        for (int p = 0; p < points; p++) {
+            ImGui::BezierGeometry::Knot knot;
+            knot.pos = ImVec2(coordinate(generator) * size.x, coordinate(generator) * size.y);
+            data.knots.push_back(knot);
+        }
+        bezierCurves.push_back(ImGui::DraggableBezierCurve::Deserialize(ImGui::BezierGeometry::Serialize(data)));
+    }
+    return bezierCurves;
+}
+
+/**
+ * main() - функция, с которой начинается выполнение программы
+ * @brief Точка входа
+ * @param argc Число аргументов.
+ * @param argv Аргументы: необязательный путь к файлу кривых.
+ * @return Результат работы программы
+ */
+int main(int argc, char** argv) {
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1920, 1080);
+    io.IniFilename = nullptr;
+
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    const int frames = 100;
+
+    std::vector<ImGui::DraggableBezierCurve> bezierCurves;
+    if (argc > 1) {
+        std::ifstream file(argv[1]);
+        if (!file) {
+            fprintf(stderr, "Cannot open %s\n", argv[1]);
+            return 1;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            ImGui::DraggableBezierCurve curve;
+            if (ImGui::DraggableBezierCurve::TryDeserialize(line, curve)) bezierCurves.push_back(curve);
+        }
+    }
+    else bezierCurves = RandomCurves(200, 50, io.DisplaySize);
+
+    size_t segmentCount = 0;
+    for (const auto& curve : bezierCurves) segmentCount += curve.GetSegmentCount();
+    printf("%zu curves, %zu segments, %d frames\n", bezierCurves.size(), segmentCount, frames);
+    printf("%-22s %12s %12s %12s\n", "stroke", "vertices", "indices", "ms/frame");
+    for (bool batched : { false, true }) {
+        StrokeStats stats = MeasureStroke(bezierCurves, batched, frames);
+        printf("%-22s %12d %12d %12.3f\n", batched ? "batched polyline" : "AddBezierCubic each", stats.vertices, stats.indices, stats.milliseconds);
+    }
+
+    ImGui::DestroyContext();
+    return 0;
+}
@@ -50,8 +50,9 @@ void LoadCurvesFromFile(const std::string& filename, std::vector<ImGui::Draggabl
     std::string line;
     if (file.is_open()) {
         while (getline(file, line)) {
-            if (!line.empty()) {
-                tempCurves.push_back(ImGui::DraggableBezierCurve::Deserialize(line));
+            ImGui::DraggableBezierCurve curve;
+            if (!line.empty() && ImGui::DraggableBezierCurve::TryDeserialize(line, curve)) {
+                tempCurves.push_back(curve);
             }
         }
         file.close();
@@ -102,6 +103,7 @@ int main() {
     bezierCurves.emplace_back();
     int selectedCurveIndex = 0;
     bool editMode = false;
+    bool freehandMode = false;
 
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
@@ -165,11 +167,18 @@ int main() {
         
         if (ImGui::RadioButton("Edit Mode", editMode)) editMode = !editMode;
         if (selectedCurveIndex == 0) editMode = false;
+        ImGui::SameLine();
+        ImGui::Checkbox("Freehand", &freehandMode);
 
         ImVec4 color = ImU32toImVec4(*bezierCurves[selectedCurveIndex].GetColor());
         if (ImGui::ColorEdit4("Color", (float*)&color)) bezierCurves[selectedCurveIndex].SetColor(ImVec4toImU32(color));
         ImGui::SliderFloat("Thickness", bezierCurves[selectedCurveIndex].GetThickness(), 1.0f, 10.0f);
         ImGui::Checkbox("Closed Curve", bezierCurves[selectedCurveIndex].GetClosed());
+        ImGui::SameLine();
+        ImGui::Checkbox("Filled", bezierCurves[selectedCurveIndex].GetFilled());
+
+        ImVec4 fillColor = ImU32toImVec4(*bezierCurves[selectedCurveIndex].GetFillColor());
+        if (ImGui::ColorEdit4("Fill Color", (float*)&fillColor)) bezierCurves[selectedCurveIndex].SetFillColor(ImVec4toImU32(fillColor));
 
         ImGui::Text("Intersects: %s", bezierCurves[selectedCurveIndex].IsSelfIntersecting() ? "true" : "false");
 
@@ -181,11 +190,16 @@ int main() {
         ImVec2 zoneSize = ImGui::ZoneMapper::GetZoneSize();
 
         if (editMode) {
-            if (ImGui::IsMouseClicked(0) && bezierCurves[selectedCurveIndex].dotIndex(12.0f) == -1 &&
+            ImVec2 relativeMousePos = ImVec2(mPos.x - zonePos.x, mPos.y - zonePos.y);
+            if (bezierCurves[selectedCurveIndex].IsStroking()) {
+                if (ImGui::IsMouseDown(0)) bezierCurves[selectedCurveIndex].ContinueStroke(relativeMousePos);
+                else bezierCurves[selectedCurveIndex].EndStroke();
+            }
+            else if (ImGui::IsMouseClicked(0) && bezierCurves[selectedCurveIndex].dotIndex(12.0f) == -1 &&
                 mPos.x >= zonePos.x && mPos.x < zoneSize.x + zonePos.x &&
                 mPos.y >= zonePos.y && mPos.y < zoneSize.y + zonePos.y) {
-                ImVec2 relativeMousePos = ImVec2(mPos.x - zonePos.x, mPos.y - zonePos.y);
-                bezierCurves[selectedCurveIndex].AddPoint(relativeMousePos);
+                if (freehandMode) bezierCurves[selectedCurveIndex].BeginStroke(relativeMousePos);
+                else bezierCurves[selectedCurveIndex].AddPoint(relativeMousePos);
             }
             if (ImGui::IsMouseClicked(1)) {
                 bezierCurves[selectedCurveIndex].DeletePoint(bezierCurves[selectedCurveIndex].dotIndex(12.0f));
@@ -196,6 +210,11 @@ int main() {
             bezierCurve.Draw(&bezierCurve == &bezierCurves[selectedCurveIndex] && editMode);
         }
 
+        if (editMode) {
+            for (const ImVec2& point : bezierCurves[selectedCurveIndex].GetIntersectionPoints())
+                ImGui::GetWindowDrawList()->AddCircle(ImVec2(point.x + zonePos.x, point.y + zonePos.y), 6.0f, IM_COL32(255, 255, 0, 255), 0, 2.0f);
+        }
+
         ImGui::ZoneMapper::EndZone();
         ImGui::EndChild();
         
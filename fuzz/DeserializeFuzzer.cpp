@@ -0,0 +1,101 @@
+#define IMGUI_DEFINE_MATH_OPERATORS
+
+#include <imgui.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "DraggableBezierCurve.h"
+
+/**
+ * @file DeserializeFuzzer.cpp
+ * Файл, содержащий точку входа libFuzzer для разбора сериализованных кривых
+ * @brief Фаззер Deserialize
+ */
+
+/**
+ * Наибольшее число вершин выборки, при котором ответ IsSelfIntersecting сверяется с перебором всех пар звеньев.
+ */
+static const size_t maxBruteForceSamples = 2000;
+
+/**
+ * Завершает процесс, если нарушено свойство, которое должно выполняться для любого входа.
+ */
+#define FUZZ_REQUIRE(condition) do { if (!(condition)) { fprintf(stderr, "FUZZ_REQUIRE(%s) failed\n", #condition); abort(); } } while (0)
+
+/**
+ * Разбирает вход как сериализованную кривую и, если он принят, проверяет повторный разбор и геометрические запросы,
+ * сверяя проверку самопересечения с перебором на небольших кривых.
+ * @param data Байты входа.
+ * @param size Число байт.
+ * @return Всегда 0.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const std::string input(reinterpret_cast<const char*>(data), size);
+
+    ImGui::DraggableBezierCurve curve;
+    if (!ImGui::DraggableBezierCurve::TryDeserialize(input, curve)) {
+        FUZZ_REQUIRE(curve.GetSegmentCount() == 0 && curve.GetBounds().IsEmpty());
+        return 0;
+    }
+
+    const std::string serialized = curve.Serialize();
+    ImGui::DraggableBezierCurve reparsed;
+    FUZZ_REQUIRE(ImGui::DraggableBezierCurve::TryDeserialize(serialized, reparsed));
+    FUZZ_REQUIRE(reparsed.Serialize() == serialized);
+
+    // Запросы выполняются для любых принятых координат: у больших координат контрольные точки могут переполниться,
+    // и от запросов требуется только отсутствие сбоев и согласие индекса пересечений с перебором.
+    const bool intersecting = curve.IsSelfIntersecting();
+    FUZZ_REQUIRE(curve.GetIntersectionPoints().empty() == !intersecting);
+    curve.GetBounds();
+    curve.GetArea();
+
+    ImGui::BezierGeometry::CurveData parsed;
+    FUZZ_REQUIRE(ImGui::BezierGeometry::TryDeserialize(input, parsed));
+    std::vector<ImVec2> knots, controls, flattened;
+    for (const auto& knot : parsed.knots) knots.push_back(knot.pos);
+    size_t samples = ImGui::BezierGeometry::IntersectionSampleCount(knots.size(), parsed.closed);
+    if (knots.size() >= 3 && samples <= maxBruteForceSamples) {
+        ImGui::BezierGeometry::ControlPoints(knots, parsed.closed, controls);
+        ImGui::BezierGeometry::Flatten(knots, controls, parsed.closed, flattened);
+
+        bool expected = false;
+        for (size_t i = 0; i + 1 < samples && !expected; i++)
+            for (size_t j = i + 2; j + 1 < samples && !expected; j++)
+                expected = ImGui::BezierGeometry::SegmentsIntersect(flattened[i], flattened[i + 1], flattened[j], flattened[j + 1]);
+        FUZZ_REQUIRE(intersecting == expected);
+    }
+    return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+/**
+ * main() - функция, с которой начинается выполнение программы без libFuzzer, например под AFL или в ctest
+ * @brief Точка входа
+ * @param argc Число аргументов.
+ * @param argv Пути к входным файлам; если их нет, вход читается из стандартного потока.
+ * @return 0, если все входы обработаны, 1, если файл не удалось открыть
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        const std::string input((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+        return LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            fprintf(stderr, "Cannot open %s\n", argv[i]);
+            return 1;
+        }
+        const std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,1058 @@
+#pragma once
+#define IMGUI_DEFINE_MATH_OPERATORS
+
+#include <imgui.h>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdio>
+#include <cfloat>
+#include <cerrno>
+#include <cctype>
+#include <cstdlib>
+
+#include "Helpers.h"
+
+/**
+* @file BezierGeometry.h
+* ,    ,    ImGui:  ,    ,
+*  , , ,   .
+*  ImGui       imgui.h,    
+*       ImGui.
+* @brief   
+*/
+
+namespace ImGui {
+
+    /**
+     * @brief  ,     .
+     *    Min  Max      .
+     */
+    struct BoundingBox {
+        ImVec2 Min = ImVec2(FLT_MAX, FLT_MAX); ///<   .
+        ImVec2 Max = ImVec2(-FLT_MAX, -FLT_MAX); ///<   .
+
+        /**
+         * ,   .
+         * @return  , ,    (true)   (false).
+         */
+        bool IsEmpty() const { return Min.x > Max.x || Min.y > Max.y; }
+        /**
+         *   ,    .
+         * @param p .
+         */
+        void Add(const ImVec2& p) { Min = ImVec2(std::min(Min.x, p.x), std::min(Min.y, p.y)); Max = ImVec2(std::max(Max.x, p.x), std::max(Max.y, p.y)); }
+        /**
+         *   ,     .
+         * @param other  .
+         */
+        void Add(const BoundingBox& other) { if (!other.IsEmpty()) { Add(other.Min); Add(other.Max); } }
+        /**
+         * ,         .
+         * @param p .
+         * @return  , ,      (true)   (false).
+         */
+        bool Contains(const ImVec2& p) const { return p.x >= Min.x && p.x <= Max.x && p.y >= Min.y && p.y <= Max.y; }
+        /**
+         * ,     .
+         * @param other  .
+         * @return  , ,       (true)   (false).
+         */
+        bool Overlaps(const BoundingBox& other) const { return Min.x <= other.Max.x && other.Min.x <= Max.x && Min.y <= other.Max.y && other.Min.y <= Max.y; }
+    };
+
+    /**
+     * @brief   ,   .
+     *     ,     -   ,
+     *        .
+     *           .
+     *      IntersectionIndex,     .
+     */
+    namespace BezierGeometry {
+
+        constexpr float increment = 0.05f; ///<  ,     .
+        constexpr int steps = 20; ///<      , 1 / increment.
+
+        /**
+         * @brief       .
+         */
+        struct Knot {
+            ImVec2 pos; ///<  .
+            float radius = 5.0f; ///<  .
+            ImU32 color = IM_COL32(255, 0, 0, 255); ///<  .
+        };
+
+        /**
+         * @brief     ,    .
+         */
+        struct CurveData {
+            bool closed = false; ///<  .
+            float thickness = 2.0f; ///<  .
+            ImU32 color = IM_COL32(255, 0, 0, 255); ///<  .
+            std::vector<Knot> knots; ///<  .
+        };
+
+        /**
+         *    .
+         * @param size   .
+         * @param closed  .
+         * @return      .
+         */
+        inline size_t SegmentCount(size_t size, bool closed) { return size < 2 ? 0 : size - !closed; }
+
+        /**
+         *      .
+         * @param t ,    ,   .
+         * @param p0      .
+         * @param p1      .
+         * @param p2      .
+         * @param p3      .
+         * @return     .
+         */
+        inline ImVec2 BezierPoint(float t, const ImVec2& p0, const ImVec2& p1, const ImVec2& p2, const ImVec2& p3) {
+            float u = 1 - t;
+            return p0 * (u * u * u) + p1 * (3 * u * u * t) + p2 * (3 * u * t * t) + p3 * (t * t * t);
+        }
+
+        /**
+         *       .
+         *     ,          .
+         * @param p0      .
+         * @param p1      .
+         * @param p2      .
+         * @param p3      .
+         * @return   .
+         */
+        inline BoundingBox BezierBounds(const ImVec2& p0, const ImVec2& p1, const ImVec2& p2, const ImVec2& p3) {
+            BoundingBox box;
+            box.Add(p0);
+            box.Add(p3);
+
+            //   ,   3: a * t^2 + b * t + c.
+            //     q / a  c / q,  q = -(b + sign(b) * sqrt(D)) / 2:  q   
+            //   ,  ,   -c / b,       b  c  a.
+            auto addExtrema = [&](float v0, float v1, float v2, float v3) {
+                float a = -v0 + 3.0f * v1 - 3.0f * v2 + v3;
+                float b = 2.0f * (v0 - 2.0f * v1 + v2);
+                float c = v1 - v0;
+                float scale = std::max({ std::fabs(a), std::fabs(b), std::fabs(c) });
+                float roots[2];
+                int count = 0;
+
+                if (!(scale > 0.0f)) return;
+                if (std::fabs(a) <= scale * FLT_EPSILON) {
+                    if (b != 0.0f) roots[count++] = -c / b;
+                }
+                else {
+                    double discriminant = (double)b * b - 4.0 * (double)a * c;
+                    if (discriminant >= 0.0) {
+                        double q = -0.5 * (b + std::copysign(std::sqrt(discriminant), (double)b));
+                        roots[count++] = (float)(q / a);
+                        if (q != 0.0) roots[count++] = (float)(c / q);
+                    }
+                }
+
+                for (int k = 0; k < count; k++)
+                    if (roots[k] > 0.0f && roots[k] < 1.0f) box.Add(BezierPoint(roots[k], p0, p1, p2, p3));
+            };
+
+            addExtrema(p0.x, p1.x, p2.x, p3.x);
+            addExtrema(p0.y, p1.y, p2.y, p3.y);
+            return box;
+        }
+
+        /**
+         *     p1-p2   .
+         * @param p0 ,  .
+         * @param p1   .
+         * @param p2   .
+         * @param p3 ,   .
+         * @param cp1     ,    .
+         * @param cp2     ,    .
+         */
+        inline void ControlPoints(const ImVec2& p0, const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, ImVec2& cp1, ImVec2& cp2) {
+            ImVec2 tangentAtP1 = Normalize((p2 - p0) * 0.5f);
+            ImVec2 tangentAtP2 = Normalize((p3 - p1) * 0.5f);
+
+            cp1 = p1 + tangentAtP1 * (Len(p1 - p0) / 4.0f);
+            cp2 = p2 - tangentAtP2 * (Len(p2 - p1) / 4.0f);
+        }
+
+        /**
+         *     ,    .
+         * @param knots   .
+         * @param closed  .
+         * @param i    .
+         * @param cp1     ,    .
+         * @param cp2     ,    .
+         */
+        inline void ControlPoints(const std::vector<ImVec2>& knots, bool closed, size_t i, ImVec2& cp1, ImVec2& cp2) {
+            size_t size = knots.size();
+
+            ImVec2 p0 = knots[(size + i - 1) % size];
+            ImVec2 p1 = knots[i];
+            ImVec2 p2 = knots[(i + 1) % size];
+            ImVec2 p3 = knots[(i + 2) % size];
+
+            if (!closed) {
+                if (i == 0) p0 = p1;
+                if (i == size - 2) p3 = p2;
+            }
+
+            ControlPoints(p0, p1, p2, p3, cp1, cp2);
+        }
+
+        /**
+         *      .
+         * @param knots   .
+         * @param closed  .
+         * @param controls  ,    .
+         */
+        inline void ControlPoints(const std::vector<ImVec2>& knots, bool closed, std::vector<ImVec2>& controls) {
+            size_t segments = SegmentCount(knots.size(), closed);
+            controls.resize(2 * segments);
+            for (size_t i = 0; i < segments; i++) ControlPoints(knots, closed, i, controls[2 * i], controls[2 * i + 1]);
+        }
+
+        /**
+         *         ,    .
+         * @param p0      .
+         * @param p1      .
+         * @param p2      .
+         * @param p3      .
+         * @param count  .
+         * @param out     count .
+         */
+        inline void FlattenSegment(const ImVec2& p0, const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, int count, ImVec2* out) {
+            for (int k = 0; k < count; k++) out[k] = BezierPoint((float)k / count, p0, p1, p2, p3);
+        }
+
+        /**
+         *    :  steps        .
+         * @param knots   .
+         * @param controls  ,    .
+         * @param closed  .
+         * @param flattened  .
+         */
+        inline void Flatten(const std::vector<ImVec2>& knots, const std::vector<ImVec2>& controls, bool closed, std::vector<ImVec2>& flattened) {
+            size_t size = knots.size();
+            size_t segments = SegmentCount(size, closed);
+            flattened.resize(segments * steps + (!closed || segments == 0 ? std::min<size_t>(size, 1) : 0));
+            for (size_t i = 0; i < segments; i++)
+                FlattenSegment(knots[i], controls[2 * i], controls[2 * i + 1], knots[(i + 1) % size], steps, &flattened[i * steps]);
+            if (!flattened.empty() && (!closed || segments == 0)) flattened.back() = knots.back();
+        }
+
+        /**
+         *      ,   "a"  "b",    "p".
+         * @param a    .
+         * @param b    .
+         * @param p ,        .
+         * @return  .
+         */
+        inline ImVec2 ClosestPointOnLine(const ImVec2& a, const ImVec2& b, const ImVec2& p) {
+            ImVec2 ab = b - a;
+            return a + ab * std::clamp(DotProduct(p - a, ab) / Quad(ab), 0.0f, 1.0f);
+        }
+
+        /**
+         *      .
+         * @param polyline  .
+         * @param p ,    .
+         * @return     'p'   .
+         */
+        inline float DistanceToPolyline(const std::vector<ImVec2>& polyline, const ImVec2& p) {
+            if (polyline.size() == 1) return Dist(polyline[0], p);
+
+            float distance = FLT_MAX;
+            for (size_t i = 0; i + 1 < polyline.size(); i++) {
+                const ImVec2& a = polyline[i];
+                const ImVec2& b = polyline[i + 1];
+                distance = std::min(distance, (Quad(b - a) > 0.0f) ? Dist(ClosestPointOnLine(a, b, p), p) : Dist(a, p));
+            }
+            return distance;
+        }
+
+        /**
+         * ,    'q'    'pr'.
+         * @param p    .
+         * @param q  .
+         * @param r    .
+         * @return  , ,    'q'    'pr' (true)   (false).
+         */
+        inline bool OnSegment(const ImVec2& p, const ImVec2& q, const ImVec2& r) {
+            return q.x <= std::max(p.x, r.x) && q.x >= std::min(p.x, r.x) && q.y <= std::max(p.y, r.y) && q.y >= std::min(p.y, r.y);
+        }
+
+        /**
+         * ,      ('p1q1'  'p2q2').
+         * @param p1     .
+         * @param q1     .
+         * @param p2     .
+         * @param q2     .
+         * @return  , ,    (true)   (false).
+         */
+        inline bool SegmentsIntersect(const ImVec2& p1, const ImVec2& q1, const ImVec2& p2, const ImVec2& q2) {
+            //    double:  float       1e-22  
+            //  ,         .
+            auto orientation = [](const ImVec2& p, const ImVec2& q, const ImVec2& r) {
+                double val = ((double)q.y - p.y) * ((double)r.x - q.x) - ((double)q.x - p.x) * ((double)r.y - q.y);
+                if (val == 0.0) return 0;
+                return (val > 0.0) ? 1 : 2;
+            };
+
+            int o1 = orientation(p1, q1, p2);
+            int o2 = orientation(p1, q1, q2);
+            int o3 = orientation(p2, q2, p1);
+            int o4 = orientation(p2, q2, q1);
+
+            if (o1 != o2 && o3 != o4) return true;
+
+            if (o1 == 0 && OnSegment(p1, p2, q1)) return true;
+            if (o2 == 0 && OnSegment(p1, q2, q1)) return true;
+            if (o3 == 0 && OnSegment(p2, p1, q2)) return true;
+            if (o4 == 0 && OnSegment(p2, q1, q2)) return true;
+
+            return false;
+        }
+
+        /**
+         *     ,   SegmentsIntersect()  true.
+         *          ,   .
+         * @param p1     .
+         * @param q1     .
+         * @param p2     .
+         * @param q2     .
+         * @return  .
+         */
+        inline ImVec2 SegmentIntersection(const ImVec2& p1, const ImVec2& q1, const ImVec2& p2, const ImVec2& q2) {
+            ImVec2 r = q1 - p1;
+            ImVec2 s = q2 - p2;
+            float denominator = r.x * s.y - r.y * s.x;
+            if (denominator != 0.0f) {
+                ImVec2 d = p2 - p1;
+                return p1 + r * std::clamp((d.x * s.y - d.y * s.x) / denominator, 0.0f, 1.0f);
+            }
+
+            if (OnSegment(p1, p2, q1)) return p2;
+            if (OnSegment(p1, q2, q1)) return q2;
+            return p1;
+        }
+
+        /**
+         * @brief     .
+         *      ,         .
+         *      :    
+         *         .
+         */
+        class IntersectionIndex {
+        public:
+            /**
+             *    .
+             * @param vertices   .
+             * @param closed  .
+             * @return  :     ,  ,   -   .
+             */
+            static size_t EdgeCount(size_t vertices, bool closed) { return vertices < 2 ? 0 : vertices - !closed; }
+
+            /**
+             *   .
+             *       ,      .
+             * @param polyline ,    .
+             * @param vertices    polyline,  .
+             * @param closed  :       .
+             */
+            void Build(const std::vector<ImVec2>& polyline, size_t vertices, bool closed) {
+                vertexCount = vertices;
+                edgeCount = EdgeCount(vertices, closed);
+                isClosed = closed;
+
+                cells.clear();
+                large.clear();
+                pairs.clear();
+                partners.assign(edgeCount, {});
+                edgeCells.assign(edgeCount, EdgeCells());
+                seen.assign(edgeCount, 0);
+                stamp = 0;
+                pointsValid = false;
+
+                BoundingBox bounds;
+                double length = 0.0;
+                for (size_t e = 0; e < edgeCount; e++) {
+                    bounds.Add(polyline[e]);
+                    length += Dist(polyline[e], polyline[(e + 1) % vertices]);
+                }
+                float extent = bounds.IsEmpty() ? 0.0f : std::max(bounds.Max.x - bounds.Min.x, bounds.Max.y - bounds.Min.y);
+                //  ForEachCell      ,     1e-5  ,
+                //         ,   .
+                float magnitude = bounds.IsEmpty() ? 0.0f : std::max({ std::fabs(bounds.Min.x), std::fabs(bounds.Min.y), std::fabs(bounds.Max.x), std::fabs(bounds.Max.y) });
+                cellSize = std::max({ edgeCount ? (float)(2.0 * length / edgeCount) : 0.0f, extent / maxCellsPerAxis, magnitude * 1e-5f, FLT_MIN });
+
+                for (size_t e = 0; e < edgeCount; e++) Insert(polyline, (unsigned int)e);
+            }
+
+            /**
+             *             .
+             *      ,         edges.
+             *            ,     .
+             *    ,         .
+             * @param polyline ,    ,  .
+             * @param vertices    polyline,  .
+             * @param edges  ,   .  e   e  e + 1.
+             */
+            void Update(const std::vector<ImVec2>& polyline, size_t vertices, const std::vector<unsigned int>& edges) {
+                size_t count = EdgeCount(vertices, isClosed);
+                size_t common = std::min(count, edgeCount);
+
+                for (unsigned int e : edges) if (e < edgeCount) Remove(e);
+                for (size_t e = common; e < edgeCount; e++) Remove((unsigned int)e);
+                //             .
+                if (isClosed && count != edgeCount && common > 0) Remove((unsigned int)(common - 1));
+
+                vertexCount = vertices;
+                edgeCount = count;
+                partners.resize(count);
+                edgeCells.resize(count);
+                seen.resize(count, 0);
+
+                for (unsigned int e : edges) if (e < edgeCount && !edgeCells[e].inserted) Insert(polyline, e);
+                for (size_t e = common == 0 ? 0 : common - 1; e < edgeCount; e++) if (!edgeCells[e].inserted) Insert(polyline, (unsigned int)e);
+            }
+
+            /**
+             * ,       .
+             * @return  , ,      (true)   (false).
+             */
+            bool IsIntersecting() const { return !pairs.empty(); }
+
+            /**
+             *     .
+             * @return    ,    ,     .
+             */
+            const std::vector<ImVec2>& GetPoints() {
+                if (!pointsValid) {
+                    std::vector<std::pair<uint64_t, ImVec2>> sorted(pairs.begin(), pairs.end());
+                    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+                    points.clear();
+                    for (const auto& pair : sorted) points.push_back(pair.second);
+                    pointsValid = true;
+                }
+                return points;
+            }
+
+        private:
+            /**
+             * @brief    .
+             */
+            struct EdgeCells {
+                ImVec2 a, b; ///<        ,       .
+                bool large = false; ///<          large.
+                bool inserted = false; ///<    .
+            };
+
+            static constexpr float maxCellsPerAxis = 4096.0f; ///<       .
+            static constexpr double maxCellsPerEdge = 4.0 * maxCellsPerAxis; ///<   ,     .
+
+            size_t vertexCount = 0; ///<   .
+            size_t edgeCount = 0; ///<  .
+            bool isClosed = false; ///<  .
+            float cellSize = 1.0f; ///<   .
+            std::unordered_map<uint64_t, std::vector<unsigned int>> cells; ///<    .
+            std::vector<unsigned int> large; ///< ,     .
+            std::vector<EdgeCells> edgeCells; ///<     .
+            std::vector<std::vector<unsigned int>> partners; ///< ,     .
+            std::unordered_map<uint64_t, ImVec2> pairs; ///<       .
+            std::vector<unsigned int> seen; ///<     ,   .
+            unsigned int stamp = 0; ///<   .
+            std::vector<ImVec2> points; ///<  ,   .
+            bool pointsValid = false; ///<   points.
+
+            /**
+             *    :     .
+             */
+            static uint64_t PairKey(unsigned int a, unsigned int b) { return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a; }
+            /**
+             *    .
+             */
+            static uint64_t CellKey(int x, int y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+            /**
+             *  ,    ,     .
+             *     ,           ,
+             *      ,      .
+             * @param a   .
+             * @param b   .
+             * @param visit ,     .
+             * @return false,    maxCellsPerEdge    ;    .
+             */
+            template <typename Visit>
+            bool ForEachCell(ImVec2 a, ImVec2 b, Visit visit) const {
+                if (a.x > b.x) std::swap(a, b);
+                double ax = a.x / (double)cellSize, ay = a.y / (double)cellSize;
+                double bx = b.x / (double)cellSize, by = b.y / (double)cellSize;
+                double margin = 0.05 + 1e-5 * std::max({ std::fabs(ax), std::fabs(ay), std::fabs(bx), std::fabs(by) });
+
+                double x0 = std::floor(ax - margin), x1 = std::floor(bx + margin);
+                double yMin = std::floor(std::min(ay, by) - margin), yMax = std::floor(std::max(ay, by) + margin);
+                //               .
+                if (!((x1 - x0 + 1.0) * (2.0 * margin + 2.0) + (yMax - yMin + 1.0) <= maxCellsPerEdge)) return false;
+
+                double slope = bx > ax ? (by - ay) / (bx - ax) : 0.0;
+                for (double x = x0; x <= x1; x++) {
+                    double y0 = bx > ax ? ay + (std::clamp(x, ax, bx) - ax) * slope : ay;
+                    double y1 = bx > ax ? ay + (std::clamp(x + 1.0, ax, bx) - ax) * slope : by;
+                    double low = std::max(std::floor(std::min(y0, y1) - margin), yMin);
+                    double high = std::min(std::floor(std::max(y0, y1) + margin), yMax);
+                    for (double y = low; y <= high; y++) visit(CellKey((int)x, (int)y));
+                }
+                return true;
+            }
+            /**
+             * ,   ,          .
+             */
+            bool Adjacent(unsigned int a, unsigned int b) const {
+                unsigned int low = std::min(a, b), high = std::max(a, b);
+                return high - low <= 1 || (isClosed && low == 0 && high == edgeCount - 1);
+            }
+
+            /**
+             *     ,         .
+             */
+            void Insert(const std::vector<ImVec2>& polyline, unsigned int e) {
+                const ImVec2& a = polyline[e];
+                const ImVec2& b = polyline[(e + 1) % vertexCount];
+
+                EdgeCells& edge = edgeCells[e];
+                edge.a = a;
+                edge.b = b;
+                edge.inserted = true;
+
+                if (++stamp == 0) {
+                    std::fill(seen.begin(), seen.end(), 0);
+                    stamp = 1;
+                }
+                seen[e] = stamp;
+
+                auto test = [&](unsigned int f) {
+                    if (seen[f] == stamp) return;
+                    seen[f] = stamp;
+                    if (Adjacent(e, f)) return;
+
+                    const ImVec2& c = polyline[f];
+                    const ImVec2& d = polyline[(f + 1) % vertexCount];
+                    if (!SegmentsIntersect(a, b, c, d)) return;
+
+                    //       ,       .
+                    pairs[PairKey(e, f)] = e < f ? SegmentIntersection(a, b, c, d) : SegmentIntersection(c, d, a, b);
+                    partners[e].push_back(f);
+                    partners[f].push_back(e);
+                    pointsValid = false;
+                };
+
+                for (unsigned int f : large) test(f);
+                edge.large = !ForEachCell(a, b, [&](uint64_t key) {
+                    std::vector<unsigned int>& cell = cells[key];
+                    for (unsigned int f : cell) test(f);
+                    cell.push_back(e);
+                });
+                if (edge.large) {
+                    // ,    ,     .
+                    for (unsigned int f = 0; f < edgeCount; f++) if (edgeCells[f].inserted) test(f);
+                    large.push_back(e);
+                }
+            }
+
+            /**
+             *            .
+             */
+            void Remove(unsigned int e) {
+                EdgeCells& edge = edgeCells[e];
+                if (!edge.inserted) return;
+                edge.inserted = false;
+
+                auto erase = [e](std::vector<unsigned int>& list) {
+                    auto it = std::find(list.begin(), list.end(), e);
+                    if (it != list.end()) {
+                        *it = list.back();
+                        list.pop_back();
+                    }
+                };
+
+                if (edge.large) erase(large);
+                else {
+                    ForEachCell(edge.a, edge.b, [&](uint64_t key) {
+                        auto cell = cells.find(key);
+                        if (cell == cells.end()) return;
+                        erase(cell->second);
+                        if (cell->second.empty()) cells.erase(cell);
+                    });
+                }
+
+                for (unsigned int f : partners[e]) {
+                    pairs.erase(PairKey(e, f));
+                    auto& list = partners[f];
+                    list.erase(std::find(list.begin(), list.end(), e));
+                    pointsValid = false;
+                }
+                partners[e].clear();
+            }
+        };
+
+        /**
+         *    ,    :  steps   Flatten()
+         *  ,     .      .
+         * @param size   .
+         * @param closed  .
+         * @return   .
+         */
+        inline size_t IntersectionSampleCount(size_t size, bool closed) { return SegmentCount(size, closed) * steps; }
+
+        /**
+         *      :        IntersectionSampleCount().
+         * @param knots   .
+         * @param closed  .
+         * @return  , ,      (true)   (false).         false.
+         */
+        inline bool IsSelfIntersecting(const std::vector<ImVec2>& knots, bool closed) {
+            if (knots.size() < 3) return false;
+
+            std::vector<ImVec2> controls, flattened;
+            ControlPoints(knots, closed, controls);
+            Flatten(knots, controls, closed, flattened);
+
+            IntersectionIndex index;
+            index.Build(flattened, IntersectionSampleCount(knots.size(), closed), false);
+            return index.IsIntersecting();
+        }
+
+        /**
+         * ,    ,    .
+         *         ,  -    .
+         * @param knots   .
+         * @param closed  .
+         * @param point   .
+         * @param threshold         .
+         * @return ,    .
+         */
+        inline size_t InsertIndex(const std::vector<ImVec2>& knots, bool closed, const ImVec2& point, float threshold) {
+            size_t size = knots.size();
+            if (size < 2) return size;
+
+            size_t insertIndex = size;
+            float minDistance = FLT_MAX;
+
+            for (size_t i = 0; i < size - !closed; i++) {
+                ImVec2 p1 = knots[i];
+                ImVec2 p2 = knots[(i + 1) % size];
+
+                ImVec2 cp1, cp2;
+                ControlPoints(knots, closed, i, cp1, cp2);
+
+                for (float t = 0; t <= 1; t += increment) {
+                    ImVec2 pointOnCurve = BezierPoint(t, p1, cp1, cp2, p2);
+                    float distance = Dist(point, pointOnCurve);
+
+                    if (distance < minDistance) {
+                        minDistance = distance;
+                        insertIndex = (minDistance <= threshold) ? i + 1 : insertIndex;
+                    }
+                }
+            }
+
+            if (minDistance > threshold) {
+                if (Dist(point, knots.front()) < Dist(point, knots.back())) insertIndex = 0;
+                else insertIndex = size;
+            }
+            return insertIndex;
+        }
+
+        /**
+         * ,     ,         .
+         *      --,   
+         *      ,   ,        .
+         *     :          
+         *    ,       -    .
+         *   steps + 1   .
+         * @param knots   .
+         * @param closed  .
+         * @param tolerance          .
+         * @param kept     .
+         */
+        inline void Simplify(const std::vector<ImVec2>& knots, bool closed, float tolerance, std::vector<size_t>& kept) {
+            size_t size = knots.size();
+            kept.clear();
+            if (size < (closed ? 4u : 3u)) {
+                for (size_t i = 0; i < size; i++) kept.push_back(i);
+                return;
+            }
+            tolerance = std::max(tolerance, 0.0f);
+
+            const size_t segments = size - !closed;
+
+            auto sampleSegment = [](const ImVec2& p1, const ImVec2& cp1, const ImVec2& cp2, const ImVec2& p2, std::vector<ImVec2>& out) {
+                out.clear();
+                for (int k = 0; k <= steps; k++) out.push_back(BezierPoint((float)k / steps, p1, cp1, cp2, p2));
+            };
+
+            std::vector<std::vector<ImVec2>> reference(segments);
+            for (size_t i = 0; i < segments; i++) {
+                ImVec2 cp1, cp2;
+                ControlPoints(knots, closed, i, cp1, cp2);
+                sampleSegment(knots[i], cp1, cp2, knots[(i + 1) % size], reference[i]);
+            }
+
+            //  : --   .   
+            //           .
+            std::vector<char> keep(size, 0);
+            std::vector<std::pair<size_t, size_t>> ranges;
+            keep[0] = 1;
+            if (closed) {
+                size_t farthest = 1;
+                for (size_t i = 2; i < size; i++) if (Dist(knots[0], knots[i]) > Dist(knots[0], knots[farthest])) farthest = i;
+                keep[farthest] = 1;
+                ranges.emplace_back(0, farthest);
+                ranges.emplace_back(farthest, size);
+            }
+            else {
+                keep[size - 1] = 1;
+                ranges.emplace_back(0, size - 1);
+            }
+
+            while (!ranges.empty()) {
+                auto [first, last] = ranges.back();
+                ranges.pop_back();
+                if (last - first < 2) continue;
+
+                std::vector<ImVec2> chord = { knots[first], knots[last % size] };
+                size_t worst = first;
+                float worstDistance = 0.0f;
+                for (size_t i = first + 1; i < last; i++) {
+                    float distance = DistanceToPolyline(chord, knots[i]);
+                    if (distance > worstDistance) {
+                        worstDistance = distance;
+                        worst = i;
+                    }
+                }
+
+                if (worstDistance > tolerance) {
+                    keep[worst] = 1;
+                    ranges.emplace_back(first, worst);
+                    ranges.emplace_back(worst, last);
+                }
+            }
+
+            // :       ControlPoints  
+            //   .          .
+            std::vector<ImVec2> keptKnots;
+            std::vector<ImVec2> candidate;
+            std::vector<ImVec2> original;
+            while (true) {
+                kept.clear();
+                keptKnots.clear();
+                for (size_t i = 0; i < size; i++) if (keep[i]) {
+                    kept.push_back(i);
+                    keptKnots.push_back(knots[i]);
+                }
+
+                bool refined = false;
+                auto restore = [&](size_t i) { if (!keep[i]) { keep[i] = 1; refined = true; } };
+                size_t keptSegments = kept.size() - !closed;
+                for (size_t j = 0; j < keptSegments; j++) {
+                    size_t first = kept[j];
+                    size_t span = (kept[(j + 1) % kept.size()] + size - first) % size;
+                    if (span == 0) span = size;
+
+                    ImVec2 cp1, cp2;
+                    ControlPoints(keptKnots, closed, j, cp1, cp2);
+                    sampleSegment(keptKnots[j], cp1, cp2, keptKnots[(j + 1) % keptKnots.size()], candidate);
+
+                    float error = 0.0f;
+                    for (size_t s = 0; s < span && error <= tolerance; s++)
+                        for (const ImVec2& sample : reference[(first + s) % size])
+                            error = std::max(error, DistanceToPolyline(candidate, sample));
+
+                    //  :        ,
+                    //         .
+                    if (error <= tolerance) {
+                        original.clear();
+                        for (size_t s = 0; s < span; s++) original.insert(original.end(), reference[(first + s) % size].begin(), reference[(first + s) % size].end());
+                        for (size_t k = 0; k < candidate.size() && error <= tolerance; k++) error = std::max(error, DistanceToPolyline(original, candidate[k]));
+                    }
+                    if (error <= tolerance) continue;
+
+                    size_t worst = size;
+                    float worstDistance = -1.0f;
+                    for (size_t s = 1; s < span; s++) {
+                        size_t i = (first + s) % size;
+                        float distance = DistanceToPolyline(candidate, knots[i]);
+                        if (distance > worstDistance) {
+                            worstDistance = distance;
+                            worst = i;
+                        }
+                    }
+
+                    if (worst != size) restore(worst);
+                    else {
+                        //   ,    :   .
+                        size_t before = (first + size - 1) % size;
+                        size_t after = (first + span + 1) % size;
+                        if (closed || first > 0) restore(before);
+                        if (closed || first + span + 1 < size) restore(after);
+                    }
+                }
+                if (!refined) break;
+            }
+        }
+
+        /**
+         *      ,   .
+         *         ,   .
+         * @param knots    .
+         * @param controls  ,    .
+         * @param area  .
+         * @param centroid   .      .
+         */
+        inline void AreaAndCentroid(const std::vector<ImVec2>& knots, const std::vector<ImVec2>& controls, float& area, ImVec2& centroid) {
+            //     : A = 1/2 * int(x dy - y dx), Mx = 1/3 * int(x (x dy - y dx)), My = 1/3 * int(y (x dy - y dx)).
+            //      -    8 , 
+            //  -      .
+            static const double nodes[5] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+            static const double weights[5] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+
+            double signedArea = 0.0, momentX = 0.0, momentY = 0.0;
+            for (size_t i = 0; i < controls.size() / 2; i++) {
+                ImVec2 p0 = knots[i];
+                ImVec2 p1 = controls[2 * i];
+                ImVec2 p2 = controls[2 * i + 1];
+                ImVec2 p3 = knots[(i + 1) % knots.size()];
+
+                for (int k = 0; k < 5; k++) {
+                    float t = (float)((nodes[k] + 1.0) * 0.5);
+                    float u = 1.0f - t;
+                    ImVec2 p = BezierPoint(t, p0, p1, p2, p3);
+                    ImVec2 d = (p1 - p0) * (3.0f * u * u) + (p2 - p1) * (6.0f * u * t) + (p3 - p2) * (3.0f * t * t);
+                    double cross = (double)p.x * d.y - (double)p.y * d.x;
+                    double w = weights[k] * 0.5;
+
+                    signedArea += w * cross * 0.5;
+                    momentX += w * cross * p.x / 3.0;
+                    momentY += w * cross * p.y / 3.0;
+                }
+            }
+
+            area = (float)std::fabs(signedArea);
+            if (std::fabs(signedArea) > 1e-6) centroid = ImVec2((float)(momentX / signedArea), (float)(momentY / signedArea));
+        }
+
+        /**
+         *   ,    ,    .
+         *         ,     :
+         *            16  .
+         *      ,        ,
+         *   ,            .
+         * @param polygon  .
+         * @param triangles    ,    .
+         */
+        inline void Triangulate(const std::vector<ImVec2>& polygon, std::vector<unsigned int>& triangles) {
+            triangles.clear();
+            size_t n = polygon.size();
+            if (n < 3) return;
+
+            auto cross = [](const ImVec2& a, const ImVec2& b, const ImVec2& c) { return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x); };
+
+            double doubleArea = 0.0;
+            for (size_t i = 0; i < n; i++) doubleArea += (double)polygon[i].x * polygon[(i + 1) % n].y - (double)polygon[(i + 1) % n].x * polygon[i].y;
+            const float orientation = (doubleArea >= 0.0) ? 1.0f : -1.0f;
+
+            //        .
+            std::vector<unsigned int> prev(n), next(n);
+            for (size_t i = 0; i < n; i++) {
+                prev[i] = (unsigned int)((i + n - 1) % n);
+                next[i] = (unsigned int)((i + 1) % n);
+            }
+            size_t remaining = n;
+            unsigned int current = 0;
+            auto remove = [&](unsigned int i) {
+                next[prev[i]] = next[i];
+                prev[next[i]] = prev[i];
+                remaining--;
+            };
+            for (size_t i = 0, visited = 0; visited < n && remaining > 2; visited++) {
+                unsigned int following = next[i];
+                if (polygon[i].x == polygon[following].x && polygon[i].y == polygon[following].y) remove(following);
+                else i = following;
+                current = (unsigned int)i;
+            }
+
+            auto turn = [&](unsigned int i) { return cross(polygon[prev[i]], polygon[i], polygon[next[i]]) * orientation; };
+
+            //         ,     .
+            std::vector<char> reflex(n, 0);
+            std::vector<unsigned int> reflexList;
+            for (size_t k = 0, i = current; k < remaining; k++, i = next[i]) {
+                if (turn((unsigned int)i) < 0.0f) {
+                    reflex[i] = 1;
+                    reflexList.push_back((unsigned int)i);
+                }
+            }
+
+            //   :  sqrt(r)    ,     cellItems.
+            // ,  ,         reflex.
+            BoundingBox reflexBounds;
+            for (unsigned int r : reflexList) reflexBounds.Add(polygon[r]);
+            const int cellsPerAxis = std::clamp((int)std::sqrt((double)reflexList.size()), 1, 1024);
+            const ImVec2 cellScale(reflexBounds.Max.x > reflexBounds.Min.x ? cellsPerAxis / (reflexBounds.Max.x - reflexBounds.Min.x) : 0.0f,
+                reflexBounds.Max.y > reflexBounds.Min.y ? cellsPerAxis / (reflexBounds.Max.y - reflexBounds.Min.y) : 0.0f);
+            auto cellOf = [&](float v, float min, float scale) { return (int)std::fmin(std::fmax((v - min) * scale, 0.0f), (float)(cellsPerAxis - 1)); };
+
+            std::vector<unsigned int> cellStart(cellsPerAxis * cellsPerAxis + 1, 0), cellItems(reflexList.size());
+            auto cellIndex = [&](const ImVec2& p) { return cellOf(p.y, reflexBounds.Min.y, cellScale.y) * cellsPerAxis + cellOf(p.x, reflexBounds.Min.x, cellScale.x); };
+            for (unsigned int r : reflexList) cellStart[cellIndex(polygon[r]) + 1]++;
+            for (size_t c = 1; c < cellStart.size(); c++) cellStart[c] += cellStart[c - 1];
+            {
+                std::vector<unsigned int> fill(cellStart.begin(), cellStart.end() - 1);
+                for (unsigned int r : reflexList) cellItems[fill[cellIndex(polygon[r])]++] = r;
+            }
+
+            //           .
+            auto isEar = [&](unsigned int i) {
+                float t = turn(i);
+                if (t == 0.0f) return true;
+                if (t < 0.0f) return false;
+                const ImVec2& a = polygon[prev[i]];
+                const ImVec2& b = polygon[i];
+                const ImVec2& c = polygon[next[i]];
+
+                int x0 = cellOf(std::min({ a.x, b.x, c.x }), reflexBounds.Min.x, cellScale.x), x1 = cellOf(std::max({ a.x, b.x, c.x }), reflexBounds.Min.x, cellScale.x);
+                int y0 = cellOf(std::min({ a.y, b.y, c.y }), reflexBounds.Min.y, cellScale.y), y1 = cellOf(std::max({ a.y, b.y, c.y }), reflexBounds.Min.y, cellScale.y);
+                for (int y = y0; y <= y1; y++) {
+                    for (unsigned int k = cellStart[y * cellsPerAxis + x0]; k < cellStart[y * cellsPerAxis + x1 + 1]; k++) {
+                        unsigned int r = cellItems[k];
+                        if (!reflex[r] || r == prev[i] || r == next[i]) continue;
+                        const ImVec2& p = polygon[r];
+                        if ((p.x == a.x && p.y == a.y) || (p.x == c.x && p.y == c.y)) continue;
+                        if (cross(a, b, p) * orientation >= 0.0f && cross(b, c, p) * orientation >= 0.0f && cross(c, a, p) * orientation >= 0.0f) return false;
+                    }
+                }
+                return true;
+            };
+
+            triangles.reserve(3 * (remaining - 2));
+            //      .      ,  ,
+            //        ,     .
+            size_t attempts = 0;
+            bool stalled = false;
+            while (remaining > 2) {
+                bool ear = isEar(current);
+                if (!ear && ++attempts <= (stalled ? std::min<size_t>(remaining, 16) : remaining)) {
+                    current = next[current];
+                    continue;
+                }
+
+                if (!ear) stalled = true;
+                unsigned int before = prev[current], after = next[current];
+                triangles.push_back(before);
+                triangles.push_back(current);
+                triangles.push_back(after);
+
+                reflex[current] = 0;
+                remove(current);
+                if (reflex[before] && turn(before) >= 0.0f) reflex[before] = 0;
+                if (reflex[after] && turn(after) >= 0.0f) reflex[after] = 0;
+
+                current = after;
+                attempts = 0;
+            }
+        }
+
+        /**
+         *       .
+         *    ,    std::ostream    ,       .
+         * @param curve  .
+         * @param out ,     .
+         */
+        inline void Serialize(const CurveData& curve, std::string& out) {
+            char buffer[96];
+            out.append(buffer, snprintf(buffer, sizeof(buffer), "%d,%g,%u", (int)curve.closed, curve.thickness, (unsigned int)curve.color));
+            for (const Knot& knot : curve.knots)
+                out.append(buffer, snprintf(buffer, sizeof(buffer), ",%g,%g,%g,%u", knot.pos.x, knot.pos.y, knot.radius, (unsigned int)knot.color));
+        }
+
+        /**
+         *    .
+         * @param curve  .
+         * @return    .
+         */
+        inline std::string Serialize(const CurveData& curve) {
+            std::string out;
+            Serialize(curve, out);
+            return out;
+        }
+
+        /**
+         *       .
+         *             ,   .
+         * @param data  .
+         * @param curve ,    .       .
+         * @return  , ,    (true)   (false).
+         */
+        inline bool TryDeserialize(const std::string& data, CurveData& curve) {
+            const char* cursor = data.c_str();
+            const char* const end = cursor + data.size();
+
+            //   .     ,      .
+            auto nextField = [&](const char*& first, const char*& last) {
+                if (cursor > end) return false;
+                first = cursor;
+                last = std::find(cursor, end, ',');
+                cursor = last + 1;
+                return true;
+            };
+            auto wholeField = [](const char* parsed, const char* first, const char* last) {
+                if (parsed == first) return false;
+                while (parsed < last && std::isspace((unsigned char)*parsed)) parsed++;
+                return parsed == last;
+            };
+            auto readFloat = [&](float& value) {
+                const char *first, *last;
+                if (!nextField(first, last)) return false;
+                char* parsed;
+                errno = 0;
+                value = std::strtof(first, &parsed);
+                return errno != ERANGE && std::isfinite(value) && wholeField(parsed, first, last);
+            };
+            auto readInteger = [&](unsigned long& value) {
+                const char *first, *last;
+                if (!nextField(first, last)) return false;
+                char* parsed;
+                errno = 0;
+                value = std::strtoul(first, &parsed, 10);
+                return errno != ERANGE && wholeField(parsed, first, last);
+            };
+
+            curve = CurveData();
+
+            unsigned long closed, color;
+            float thickness;
+            if (!readInteger(closed) || !readFloat(thickness) || !readInteger(color)) return false;
+
+            CurveData result;
+            result.closed = closed != 0;
+            result.thickness = thickness;
+            result.color = static_cast<ImU32>(color);
+            while (cursor <= end) {
+                Knot knot;
+                unsigned long col;
+                if (!readFloat(knot.pos.x) || !readFloat(knot.pos.y) || !readFloat(knot.radius) || !readInteger(col)) return false;
+                knot.color = static_cast<ImU32>(col);
+                result.knots.push_back(knot);
+            }
+
+            curve = std::move(result);
+            return true;
+        }
+    }
+}
@@ -21,195 +21,512 @@ namespace ImGui {
             this->isClosed = other.isClosed;
             this->color = other.color;
             this->thickness = other.thickness;
+            this->isFilled = other.isFilled;
+            this->fillColor = other.fillColor;
+            this->batchedStroke = other.batchedStroke;
             this->points = other.points;
+            this->geometry.valid = false;
         }
         return *this;
     }
 
     void DraggableBezierCurve::AddPoint(const ImVec2& newPoint, float threshold, float rad, ImU32 col) {
-        size_t size = points.size();
-        
-        if (size < 2) {
-            points.emplace_back(newPoint, rad, col);
-            return;
-        }
-
-        size_t insertIndex = size;
-        float minDistance = FLT_MAX;
+        size_t insertIndex = BezierGeometry::InsertIndex(UpdateGeometry().knots, isClosed, newPoint, threshold);
+        if (insertIndex != points.size()) geometry.valid = false;
+        points.insert(points.begin() + insertIndex, DraggableDot(newPoint, rad, col));
+    }
 
-        for (size_t i = 0; i < size - !isClosed; i++) {
-            ImVec2 p1 = points[i].GetSimplePosition();
-            ImVec2 p2 = points[(i + 1) % points.size()].GetSimplePosition();
+    void DraggableBezierCurve::DeletePoint(size_t index) {
+        if (index >= points.size()) return;
+        if (index != points.size() - 1) geometry.valid = false;
+        points.erase(points.begin() + index);
+    }
 
-            ImVec2 cp1, cp2;
-            CalculateControlPoints(i, cp1, cp2);
+    void DraggableBezierCurve::MovePoint(size_t index, const ImVec2& pos) {
+        if (index >= points.size()) return;
+        points[index].SetPosition(pos);
+        KnotMoved(index);
+    }
 
-            for (float t = 0; t <= 1; t += increment) {
-                ImVec2 pointOnCurve = CalculateBezierPoint(t, p1, cp1, cp2, p2);
-                float distance = Dist(newPoint, pointOnCurve);
+    void DraggableBezierCurve::BeginStroke(const ImVec2& point, float tolerance, float rad, ImU32 col) {
+        stroke = StrokeState();
+        stroke.active = true;
+        stroke.tolerance = std::max(tolerance, 0.0f);
+        stroke.radius = rad;
+        stroke.color = col;
+        stroke.first = points.size();
+        stroke.samples.push_back(point);
+        stroke.knotSamples.push_back(0);
+
+        points.emplace_back(point, rad, col);
+        KnotMoved(points.size() - 1);
+    }
 
-                if (distance < minDistance) {
-                    minDistance = distance;
-                    insertIndex = (minDistance <= threshold) ? i + 1 : insertIndex;
-                }
+    void DraggableBezierCurve::ContinueStroke(const ImVec2& point) {
+        if (!stroke.active) return;
+        if (stroke.first + stroke.knotSamples.size() != points.size()) {
+            stroke.active = false;
+            return;
+        }
+        //         ,       .
+        if (Dist(point, stroke.samples.back()) <= stroke.tolerance * 0.1f) return;
+
+        stroke.samples.push_back(point);
+        size_t sample = stroke.samples.size() - 1;
+        size_t last = stroke.knotSamples.size() - 1;
+
+        //     ,       .
+        if (last > 0 && sample - stroke.knotSamples[last - 1] <= maxStrokeSamples) {
+            ImVec2 tail = points.back().GetSimplePosition();
+            size_t tailSample = stroke.knotSamples[last];
+            points.back().SetPosition(point);
+            stroke.knotSamples[last] = sample;
+            if (StrokeSegmentFits(last - 1) && (last < 2 || StrokeSegmentFits(last - 2))) {
+                KnotMoved(points.size() - 1);
+                return;
             }
+            points.back().SetPosition(tail);
+            stroke.knotSamples[last] = tailSample;
         }
 
-        if (minDistance > threshold) {
-            if (Dist(newPoint, points.front().GetSimplePosition()) < Dist(newPoint, points.back().GetSimplePosition())) insertIndex = 0;
-            else insertIndex = points.size();
+        //          ,    .
+        points.emplace_back(point, stroke.radius, stroke.color);
+        KnotMoved(points.size() - 1);
+        stroke.knotSamples.push_back(sample);
+        if (last > 0 && !StrokeSegmentFits(last - 1)) SplitStrokeSegment(last - 1);
+    }
+
+    bool DraggableBezierCurve::StrokeSegmentFits(size_t k) {
+        size_t from = stroke.knotSamples[k] + 1, to = stroke.knotSamples[k + 1];
+        if (from >= to) return true;
+
+        //      ,   ControlPoints():     .
+        size_t size = points.size(), i = stroke.first + k, local = 0;
+        stroke.window.clear();
+        for (size_t j = i + size - 1; j <= i + size + 2; j++) {
+            if (isClosed) stroke.window.push_back(points[j % size].GetSimplePosition());
+            else if (j >= size && j < 2 * size) {
+                if (j - size == i) local = stroke.window.size();
+                stroke.window.push_back(points[j - size].GetSimplePosition());
+            }
         }
+        if (isClosed) local = 1;
+
+        ImVec2 cp1, cp2;
+        const ImVec2& p1 = stroke.window[local];
+        const ImVec2& p2 = stroke.window[local + 1];
+        BezierGeometry::ControlPoints(stroke.window, false, local, cp1, cp2);
+        stroke.polyline.resize(BezierGeometry::steps + 1);
+        BezierGeometry::FlattenSegment(p1, cp1, cp2, p2, BezierGeometry::steps, stroke.polyline.data());
+        stroke.polyline.back() = p2;
+
+        float tolerance = stroke.tolerance * 0.9f;
+        for (size_t s = from; s < to; s++) if (BezierGeometry::DistanceToPolyline(stroke.polyline, stroke.samples[s]) > tolerance) return false;
+        return true;
+    }
 
-        points.insert(points.begin() + insertIndex, DraggableDot(newPoint, rad, col));
+    void DraggableBezierCurve::SplitStrokeSegment(size_t k) {
+        // ,    :     ,
+        //  -    .          .
+        std::vector<size_t> pending = { k };
+        while (!pending.empty()) {
+            size_t segment = pending.back();
+            pending.pop_back();
+            if (StrokeSegmentFits(segment)) continue;
+
+            size_t from = stroke.knotSamples[segment] + 1, to = stroke.knotSamples[segment + 1];
+            std::vector<DraggableDot> dots;
+            std::vector<size_t> samples;
+            for (size_t s = from; s < to; s++) {
+                dots.emplace_back(stroke.samples[s], stroke.radius, stroke.color);
+                samples.push_back(s);
+            }
+            points.insert(points.begin() + stroke.first + segment + 1, dots.begin(), dots.end());
+            stroke.knotSamples.insert(stroke.knotSamples.begin() + segment + 1, samples.begin(), samples.end());
+            geometry.valid = false;
+
+            size_t count = to - from;
+            for (size_t& other : pending) if (other > segment) other += count;
+            if (segment > 0) pending.push_back(segment - 1);
+            if (segment + count + 2 < stroke.knotSamples.size()) pending.push_back(segment + count + 1);
+        }
     }
 
     void DraggableBezierCurve::Draw(bool editable) {
-        if (editable) for (auto& dot : points) {
+        Draw(ZoneMapper::Current(), editable);
+    }
+
+    void DraggableBezierCurve::Draw(const ZoneMapper& zones, bool editable) {
+        if (editable) for (size_t i = 0; i < points.size(); i++) {
+            DraggableDot& dot = points[i];
+            ImVec2 position = dot.GetSimplePosition();
             dot.SetColor(color);
-            dot.Draw();
+            dot.Draw(zones);
+            if (dot.GetSimplePosition() != position) KnotMoved(i);
         }
 
-        int size = points.size();
+        Draw(ImGui::GetWindowDrawList(), zones);
+    }
+
+    void DraggableBezierCurve::Draw(ImDrawList* draw_list, const ZoneMapper& zones) {
+        size_t size = points.size();
         if (size < 2) return;
 
-        ImDrawList* draw_list = ImGui::GetWindowDrawList();
-        ImVec2 zonePos = ZoneMapper::GetZonePos();
+        const GeometryCache& cache = UpdateGeometry();
+        ImVec2 zonePos = zones.GetPos();
 
-        for (size_t i = 0; i < size - !isClosed; i++) {
-            ImVec2 p1 = points[i].GetSimplePosition();
-            ImVec2 p2 = points[(i + 1) % size].GetSimplePosition();
+        if (isClosed && isFilled) DrawFill(draw_list, zonePos);
+
+        if (batchedStroke) {
+            //        :     
+            //  ,  AddPolyline      ,   .
+            draw_list->PathLineTo(cache.knots[0] + zonePos);
+            for (size_t i = 0; i < size - !isClosed; i++)
+                draw_list->PathBezierCubicCurveTo(cache.controls[2 * i] + zonePos, cache.controls[2 * i + 1] + zonePos, cache.knots[(i + 1) % size] + zonePos);
+            if (isClosed) draw_list->_Path.pop_back();
+            draw_list->PathStroke(color, isClosed ? ImDrawFlags_Closed : ImDrawFlags_None, thickness);
+            return;
+        }
 
-            ImVec2 cp1, cp2;
-            CalculateControlPoints(i % size, cp1, cp2);
+        for (size_t i = 0; i < size - !isClosed; i++) {
+            ImVec2 p1 = cache.knots[i];
+            ImVec2 p2 = cache.knots[(i + 1) % size];
+            ImVec2 cp1 = cache.controls[2 * i];
+            ImVec2 cp2 = cache.controls[2 * i + 1];
 
             draw_list->AddBezierCubic(p1 + zonePos, cp1 + zonePos, cp2 + zonePos, p2 + zonePos, color, thickness);
         }
     }
 
-    void DraggableBezierCurve::CalculateControlPoints(size_t i, ImVec2& cp1, ImVec2& cp2) {
-        int size = points.size();
-
-        ImVec2 p0 = points[(size + i - 1) % size].GetSimplePosition();
-        ImVec2 p1 = points[i].GetSimplePosition();
-        ImVec2 p2 = points[(i + 1) % size].GetSimplePosition();
-        ImVec2 p3 = points[(i + 2) % size].GetSimplePosition();
-
-        if (!isClosed) {
-            if (i == 0) p0 = p1;
-            if (i == size - 2) p3 = p2;
+    void DraggableBezierCurve::DrawFill(ImDrawList* draw_list, const ImVec2& offset) {
+        const GeometryCache& cache = UpdateGeometry();
+        if (!fill.valid || fill.revision != cache.revision) {
+            fill.valid = true;
+            fill.revision = cache.revision;
+            BezierGeometry::Triangulate(cache.flattened, fill.triangles);
+        }
+        if (fill.triangles.empty()) return;
+
+        const std::vector<ImVec2>& polygon = cache.flattened;
+        const ImVec2 uv = draw_list->_Data->TexUvWhitePixel;
+        int vtxCount = (int)polygon.size();
+        int idxCount = (int)fill.triangles.size();
+
+        //   ImDrawListFlags_AllowVtxOffset PrimReserve()    ,   ,
+        //       ,    .
+        const unsigned int indexLimit = 1u << 16;
+        bool vtxOffset = (draw_list->Flags & ImDrawListFlags_AllowVtxOffset) != 0;
+        if (sizeof(ImDrawIdx) == 4 || (unsigned int)vtxCount <= (vtxOffset ? indexLimit : indexLimit - std::min(draw_list->_VtxCurrentIdx, indexLimit))) {
+            draw_list->PrimReserve(idxCount, vtxCount);
+            unsigned int base = draw_list->_VtxCurrentIdx;
+            for (const ImVec2& p : polygon) draw_list->PrimWriteVtx(p + offset, uv, fillColor);
+            for (unsigned int index : fill.triangles) draw_list->PrimWriteIdx((ImDrawIdx)(base + index));
+            return;
         }
 
-        ImVec2 tangentAtP1 = Normalize((p2 - p0) * 0.5f);
-        ImVec2 tangentAtP2 = Normalize((p3 - p1) * 0.5f);
+        // 16-      :      .
+        //       ,  ,    ,  .
+        for (int first = 0; first < idxCount;) {
+            int count = std::min(idxCount - first, 3 * 10000);
+            if (!vtxOffset) count = std::min(count, (int)((indexLimit - std::min(draw_list->_VtxCurrentIdx, indexLimit)) / 3 * 3));
+            if (count == 0) return;
 
-        cp1 = p1 + tangentAtP1 * (Len(p1 - p0) / 4.0f);
-        cp2 = p2 - tangentAtP2 * (Len(p2 - p1) / 4.0f);
+            draw_list->PrimReserve(count, count);
+            for (int k = first; k < first + count; k++) draw_list->PrimVtx(polygon[fill.triangles[k]] + offset, uv, fillColor);
+            first += count;
+        }
     }
 
-    bool DraggableBezierCurve::IsSelfIntersecting() {
-        int size = points.size();
+    BoundingBox DraggableBezierCurve::GetBounds() {
+        return UpdateGeometry().bounds;
+    }
 
-        if (points.size() < 3) return false;
+    BoundingBox DraggableBezierCurve::GetSegmentBounds(size_t i) {
+        const GeometryCache& cache = UpdateGeometry();
+        return (i < cache.segmentBounds.size()) ? cache.segmentBounds[i] : BoundingBox();
+    }
 
-        std::vector<ImVec2> lineSegments;
+    const std::vector<BoundingBox>& DraggableBezierCurve::GetSegmentBounds() {
+        return UpdateGeometry().segmentBounds;
+    }
 
-        for (size_t i = 0; i < size - !isClosed; i++) {
-            ImVec2 p1 = points[i % size].GetSimplePosition();
-            ImVec2 p2 = points[(i + 1) % size].GetSimplePosition();
+    void DraggableBezierCurve::KnotMoved(size_t i) {
+        if (!geometry.valid) return;
+        // ,   ,  :          .
+        //  ,    ;     ,    .
+        if (geometry.movedKnots.size() >= points.size()) geometry.valid = false;
+        else geometry.movedKnots.push_back((unsigned int)i);
+    }
 
-            ImVec2 cp1, cp2;
-            CalculateControlPoints(i % size, cp1, cp2);
+    const DraggableBezierCurve::GeometryCache& DraggableBezierCurve::UpdateGeometry() {
+        size_t size = points.size();
+        size_t previous = geometry.knots.size();
+        bool same = geometry.valid && geometry.closed == isClosed;
+        if (same && size == previous && geometry.movedKnots.empty()) return geometry;
+
+        size_t segments = GetSegmentCount();
+        size_t previousSegments = geometry.segmentBounds.size();
+
+        //  i     i - 1  i + 2,   k    k - 2  k + 1.
+        //          ,    ,
+        //       ,    ,     .
+        std::vector<unsigned int> changed;
+        bool full = !same || std::min(size, previous) < 4;
+        if (!full) {
+            std::vector<size_t> knots;
+            for (unsigned int k : geometry.movedKnots) if (k < size) knots.push_back(k);
+            for (size_t k = std::min(size, previous) - 1; k < size; k++) knots.push_back(k);
+
+            for (size_t k : knots) {
+                for (size_t j = k + segments - 2; j <= k + segments + 1; j++) {
+                    if (isClosed) changed.push_back((unsigned int)(j % segments));
+                    else if (j >= segments && j < 2 * segments) changed.push_back((unsigned int)(j - segments));
+                }
+            }
+            std::sort(changed.begin(), changed.end());
+            changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+            full = changed.size() * 4 >= segments;
+        }
 
-            for (float t = 0; t <= 1; t += increment) {
-                ImVec2 pointOnCurve = CalculateBezierPoint(t, p1, cp1, cp2, p2);
-                lineSegments.push_back(pointOnCurve);
+        if (full) {
+            geometry.changedAll = true;
+            geometry.changedSegments.clear();
+            geometry.knots.resize(size);
+            for (size_t i = 0; i < size; i++) geometry.knots[i] = points[i].GetSimplePosition();
+        }
+        else {
+            geometry.knots.resize(size);
+            for (unsigned int k : geometry.movedKnots) if (k < size) geometry.knots[k] = points[k].GetSimplePosition();
+            for (size_t k = previous; k < size; k++) geometry.knots[k] = points[k].GetSimplePosition();
+        }
+        geometry.movedKnots.clear();
+
+        geometry.closed = isClosed;
+        geometry.valid = true;
+        geometry.revision++;
+        geometry.steps = BezierGeometry::steps;
+        geometry.controls.resize(2 * segments);
+        geometry.segmentBounds.resize(segments);
+        geometry.flattened.resize(segments * geometry.steps + (!isClosed || segments == 0 ? std::min<size_t>(size, 1) : 0));
+        if (!geometry.flattened.empty() && (!isClosed || segments == 0)) geometry.flattened.back() = geometry.knots.back();
+
+        if (full) for (size_t i = 0; i < segments; i++) UpdateSegment(i);
+        else for (unsigned int i : changed) UpdateSegment(i);
+
+        //   ,      ,       .
+        size_t leaves = geometry.boundsTree.size() / 2;
+        if (full || segments > leaves) {
+            for (leaves = 1; leaves < segments; leaves *= 2) {}
+            geometry.boundsTree.assign(2 * leaves, BoundingBox());
+            std::copy(geometry.segmentBounds.begin(), geometry.segmentBounds.end(), geometry.boundsTree.begin() + leaves);
+            for (size_t i = leaves - 1; i > 0; i--) {
+                geometry.boundsTree[i] = geometry.boundsTree[2 * i];
+                geometry.boundsTree[i].Add(geometry.boundsTree[2 * i + 1]);
             }
         }
+        else {
+            for (unsigned int i : changed) UpdateBoundsTree(i, geometry.segmentBounds[i]);
+            for (size_t i = segments; i < previousSegments; i++) UpdateBoundsTree(i, BoundingBox());
+        }
+
+        if (geometry.changedSegments.size() > segments) {
+            geometry.changedAll = true;
+            geometry.changedSegments.clear();
+        }
 
-        for (size_t i = 0; i < lineSegments.size() - 1; i++)
-            for (size_t j = i + 2; j < lineSegments.size() - 1; j++)
-                if (SegmentsIntersect(lineSegments[i], lineSegments[i + 1], lineSegments[j], lineSegments[j + 1])) return true;
-        return false;
+        geometry.bounds = geometry.boundsTree[1];
+        if (size == 1) geometry.bounds.Add(geometry.knots[0]);
+
+        return geometry;
     }
 
-    size_t DraggableBezierCurve::dotIndex(float threshold) {
-        for (int i = 0; i < points.size(); i++) {
-            ImVec2 mPos = ImGui::GetMousePos();
-            ImVec2 pPos = points[i].GetSimplePosition();
-            ImVec2 zonePos = ImGui::ZoneMapper::GetZonePos();
-            
-            if(Dist(mPos - zonePos, pPos) < threshold) return i;
+    void DraggableBezierCurve::UpdateSegment(size_t i) {
+        size_t size = geometry.knots.size();
+        const ImVec2& p1 = geometry.knots[i];
+        const ImVec2& p2 = geometry.knots[(i + 1) % size];
+
+        ImVec2& cp1 = geometry.controls[2 * i];
+        ImVec2& cp2 = geometry.controls[2 * i + 1];
+        BezierGeometry::ControlPoints(geometry.knots, geometry.closed, i, cp1, cp2);
+
+        geometry.segmentBounds[i] = BezierGeometry::BezierBounds(p1, cp1, cp2, p2);
+        BezierGeometry::FlattenSegment(p1, cp1, cp2, p2, geometry.steps, &geometry.flattened[i * geometry.steps]);
+
+        if (!geometry.changedAll) geometry.changedSegments.push_back((unsigned int)i);
+    }
+
+    void DraggableBezierCurve::UpdateBoundsTree(size_t i, const BoundingBox& box) {
+        std::vector<BoundingBox>& tree = geometry.boundsTree;
+        size_t node = tree.size() / 2 + i;
+        tree[node] = box;
+        for (node /= 2; node > 0; node /= 2) {
+            tree[node] = tree[2 * node];
+            tree[node].Add(tree[2 * node + 1]);
         }
-        return -1;
     }
 
-    bool DraggableBezierCurve::onSegment(ImVec2 p, ImVec2 q, ImVec2 r) {
-        return q.x <= std::max(p.x, r.x) && q.x >= std::min(p.x, r.x) && q.y <= std::max(p.y, r.y) && q.y >= std::min(p.y, r.y);
+    bool DraggableBezierCurve::IsPointInside(const ImVec2& point) {
+        if (!isClosed || GetSegmentCount() == 0) return false;
+
+        const GeometryCache& cache = UpdateGeometry();
+        if (!cache.bounds.Contains(point)) return false;
+
+        const RegionCache& regionCache = UpdateRegion();
+        size_t bands = regionCache.bandStart.size() - 1;
+        size_t band = (size_t)std::clamp((int)std::floor((point.y - regionCache.bandTop) / regionCache.bandHeight), 0, (int)bands - 1);
+
+        const std::vector<ImVec2>& polygon = cache.flattened;
+        int winding = 0;
+        for (unsigned int e = regionCache.bandStart[band]; e < regionCache.bandStart[band + 1]; e++) {
+            size_t edge = regionCache.bandEdges[e];
+            const ImVec2& a = polygon[edge];
+            const ImVec2& b = polygon[(edge + 1) % polygon.size()];
+            float side = (b.x - a.x) * (point.y - a.y) - (point.x - a.x) * (b.y - a.y);
+
+            if (a.y <= point.y && b.y > point.y && side > 0.0f) winding++;
+            else if (b.y <= point.y && a.y > point.y && side < 0.0f) winding--;
+        }
+        return winding != 0;
     }
 
-    ImVec2 DraggableBezierCurve::ClosestPointOnLine(const ImVec2& a, const ImVec2& b, const ImVec2& p) {
-        ImVec2 ab = b - a;
-        return a + ab * std::clamp(DotProduct(p - a, ab) / Quad(ab), 0.0f, 1.0f);
+    float DraggableBezierCurve::GetArea() {
+        return UpdateRegion().area;
     }
 
-    ImVec2 DraggableBezierCurve::CalculateBezierPoint(float t, ImVec2 p0, ImVec2 p1, ImVec2 p2, ImVec2 p3) {
-        float u = 1 - t;
-        return p0 * (u * u * u) + p1 * (3 * u * u * t) + p2 * (3 * u * t * t) + p3 * (t * t * t);
+    ImVec2 DraggableBezierCurve::GetCentroid() {
+        return UpdateRegion().centroid;
     }
 
-    bool DraggableBezierCurve::SegmentsIntersect(const ImVec2& p1, const ImVec2& q1, const ImVec2& p2, const ImVec2& q2) {
-        auto orientation = [](const ImVec2& p, const ImVec2& q, const ImVec2& r) {
-            float val = (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
-            if (val == 0.0f) return 0;
-            return (val > 0.0f) ? 1 : 2;
-        };
+    const DraggableBezierCurve::RegionCache& DraggableBezierCurve::UpdateRegion() {
+        const GeometryCache& cache = UpdateGeometry();
+        if (region.valid && region.revision == cache.revision) return region;
 
-        int o1 = orientation(p1, q1, p2);
-        int o2 = orientation(p1, q1, q2);
-        int o3 = orientation(p2, q2, p1);
-        int o4 = orientation(p2, q2, q1);
+        region.valid = true;
+        region.revision = cache.revision;
+        region.area = 0.0f;
+        region.centroid = ImVec2((cache.bounds.Min.x + cache.bounds.Max.x) * 0.5f, (cache.bounds.Min.y + cache.bounds.Max.y) * 0.5f);
+        region.bandStart.assign(2, 0);
+        region.bandEdges.clear();
 
-        if (o1 != o2 && o3 != o4) return true;
+        size_t segments = cache.segmentBounds.size();
+        if (!cache.closed || segments == 0) return region;
 
-        if (o1 == 0 && onSegment(p1, p2, q1)) return true;
-        if (o2 == 0 && onSegment(p1, q2, q1)) return true;
-        if (o3 == 0 && onSegment(p2, p1, q2)) return true;
-        if (o4 == 0 && onSegment(p2, q1, q2)) return true;
+        BezierGeometry::AreaAndCentroid(cache.knots, cache.controls, region.area, region.centroid);
 
-        return false;
-    }
+        //     ,   - ,    .
+        const std::vector<ImVec2>& polygon = cache.flattened;
+        size_t edges = polygon.size();
+        size_t bands = std::clamp<size_t>(edges / 4, 1, 1024);
+        region.bandTop = cache.bounds.Min.y;
+        region.bandHeight = std::max((cache.bounds.Max.y - cache.bounds.Min.y) / bands, FLT_MIN);
 
-    std::string DraggableBezierCurve::Serialize() const {
-        std::ostringstream stream;
-        stream << isClosed << "," << thickness << "," << color;
-        for (DraggableDot dot : points) {
-            stream << "," << dot.GetSimplePosition().x << "," << dot.GetSimplePosition().y
-                << "," << *dot.GetRadius() << "," << *dot.GetColor();
+        auto bandOf = [&](float y) { return (size_t)std::clamp((int)std::floor((y - region.bandTop) / region.bandHeight), 0, (int)bands - 1); };
+
+        region.bandStart.assign(bands + 1, 0);
+        for (size_t e = 0; e < edges; e++) {
+            float y0 = polygon[e].y, y1 = polygon[(e + 1) % edges].y;
+            for (size_t b = bandOf(std::min(y0, y1)); b <= bandOf(std::max(y0, y1)); b++) region.bandStart[b + 1]++;
         }
-        return stream.str();
+        for (size_t b = 0; b < bands; b++) region.bandStart[b + 1] += region.bandStart[b];
+
+        region.bandEdges.resize(region.bandStart[bands]);
+        std::vector<unsigned int> fill(region.bandStart.begin(), region.bandStart.end() - 1);
+        for (size_t e = 0; e < edges; e++) {
+            float y0 = polygon[e].y, y1 = polygon[(e + 1) % edges].y;
+            for (size_t b = bandOf(std::min(y0, y1)); b <= bandOf(std::max(y0, y1)); b++) region.bandEdges[fill[b]++] = (unsigned int)e;
+        }
+
+        return region;
     }
 
-    DraggableBezierCurve DraggableBezierCurve::Deserialize(const std::string& data) {
-        std::istringstream stream(data);
-        std::string segment;
-        std::vector<std::string> seglist;
+    float DraggableBezierCurve::Simplify(float tolerance) {
+        size_t size = points.size();
+        std::vector<size_t> kept;
+        BezierGeometry::Simplify(UpdateGeometry().knots, isClosed, tolerance, kept);
+        if (kept.size() == size) return 1.0f;
+
+        std::vector<DraggableDot> simplified;
+        simplified.reserve(kept.size());
+        for (size_t i : kept) simplified.push_back(points[i]);
+        points.swap(simplified);
+        geometry.valid = false;
 
-        while (std::getline(stream, segment, ',')) {
-            seglist.push_back(segment);
+        return (float)size / (float)points.size();
+    }
+
+    bool DraggableBezierCurve::IsSelfIntersecting() {
+        if (points.size() < 3) return false;
+        return UpdateIntersections().IsIntersecting();
+    }
+
+    const std::vector<ImVec2>& DraggableBezierCurve::GetIntersectionPoints() {
+        static const std::vector<ImVec2> none;
+        if (points.size() < 3) return none;
+        return UpdateIntersections().GetPoints();
+    }
+
+    BezierGeometry::IntersectionIndex& DraggableBezierCurve::UpdateIntersections() {
+        const GeometryCache& cache = UpdateGeometry();
+
+        //     -   Flatten      .
+        size_t vertices = BezierGeometry::IntersectionSampleCount(cache.knots.size(), cache.closed);
+        size_t edges = BezierGeometry::IntersectionIndex::EdgeCount(vertices, false);
+
+        if (!intersections.valid || cache.changedAll || edges > 2 * intersections.builtEdges) {
+            intersections.index.Build(cache.flattened, vertices, false);
+            intersections.valid = true;
+            intersections.builtEdges = edges;
         }
+        else {
+            //   i -  i * steps  (i + 1) * steps - 1,        .
+            // ,      ,       .
+            intersections.edges.clear();
+            for (unsigned int i : cache.changedSegments)
+                for (int k = 0; k < cache.steps; k++) intersections.edges.push_back(i * cache.steps + k);
+            intersections.index.Update(cache.flattened, vertices, intersections.edges);
+        }
+
+        geometry.changedAll = false;
+        geometry.changedSegments.clear();
+        return intersections.index;
+    }
 
-        DraggableBezierCurve curve(
-            std::stoi(seglist[0]),
-            std::stof(seglist[1]),
-            static_cast<ImU32>(std::stoul(seglist[2])));
+    size_t DraggableBezierCurve::dotIndex(float threshold) {
+        return dotIndex(ZoneMapper::Current(), threshold);
+    }
 
-        for (size_t i = 3; i < seglist.size(); i += 4) {
-            ImVec2 pos(std::stoi(seglist[i]), std::stoi(seglist[i + 1]));
-            float rad = std::stof(seglist[i + 2]);
-            ImU32 col = static_cast<ImU32>(std::stoul(seglist[i + 3]));
-            curve.points.emplace_back(pos, rad, col);
+    size_t DraggableBezierCurve::dotIndex(const ZoneMapper& zones, float threshold) {
+        for (int i = 0; i < points.size(); i++) {
+            ImVec2 mPos = ImGui::GetMousePos();
+            ImVec2 pPos = points[i].GetSimplePosition();
+            ImVec2 zonePos = zones.GetPos();
+            
+            if(Dist(mPos - zonePos, pPos) < threshold) return i;
         }
+        return -1;
+    }
 
+    std::string DraggableBezierCurve::Serialize() const {
+        BezierGeometry::CurveData data;
+        data.closed = isClosed;
+        data.thickness = thickness;
+        data.color = color;
+        for (DraggableDot dot : points) data.knots.push_back({ dot.GetSimplePosition(), *dot.GetRadius(), *dot.GetColor() });
+        return BezierGeometry::Serialize(data);
+    }
+
+    DraggableBezierCurve DraggableBezierCurve::Deserialize(const std::string& data) {
+        DraggableBezierCurve curve;
+        TryDeserialize(data, curve);
         return curve;
     }
-}
\ No newline at end of file
+
+    bool DraggableBezierCurve::TryDeserialize(const std::string& data, DraggableBezierCurve& curve) {
+        BezierGeometry::CurveData parsed;
+        bool valid = BezierGeometry::TryDeserialize(data, parsed);
+
+        curve = DraggableBezierCurve(parsed.closed, parsed.thickness, parsed.color);
+        for (const BezierGeometry::Knot& knot : parsed.knots) curve.points.emplace_back(knot.pos, knot.radius, knot.color);
+        return valid;
+    }
+}
@@ -7,8 +7,10 @@
 #include <cmath>
 #include <algorithm>
 #include <sstream>
+#include <cfloat>
 
 #include "Helpers.h"
+#include "BezierGeometry.h"
 #include "ZoneMapper.h"
 #include "DraggableDot.h"
 
@@ -46,38 +48,163 @@ namespace ImGui {
         /**
          * Добавляет к кривой перетаскиваемую точку.
          * Точки добавляются таким образом, чтобы сохранить плавность кривой.
+         * Поиск места вставки перебирает все сегменты. Точка в конце кривой обновляет кэши только у соседних сегментов,
+         * вставка в середину сдвигает номера звеньев и перестраивает кэш геометрии и индекс пересечений заново.
          * @param point Положение точки.
          * @param threshold Пороговое значение расстояния для добавления точки непосредственно на кривую.
          * @param rad Радиус точки.
          * @param col Цвет точки.
          */
         void AddPoint(const ImVec2& point, float threshold = 15.0f, float rad = 5.0f, ImU32 col = IM_COL32(255, 0, 0, 255));
+        /**
+         * Начинает рисование кривой от руки: первая точка штриха добавляется в конец кривой.
+         * Дальнейшие положения указателя передаются в ContinueStroke(), штрих завершается вызовом EndStroke().
+         * Допуск ограничивает расстояние от каждого учтённого положения указателя до аппроксимирующей ломаной
+         * отображаемой кривой, по которой строятся заливка и проверки попадания. Между положениями сегменты Безье
+         * скругляют изломы пути и могут отходить от него дальше допуска.
+         * @param point Начальное положение штриха.
+         * @param tolerance Допустимое расстояние от положений указателя до кривой.
+         * @param rad Радиус добавляемых точек.
+         * @param col Цвет добавляемых точек.
+         */
+        void BeginStroke(const ImVec2& point, float tolerance = 2.0f, float rad = 5.0f, ImU32 col = IM_COL32(255, 0, 0, 255));
+        /**
+         * Передаёт очередное положение указателя в начатый штрих.
+         * Последняя точка кривой следует за указателем, пока изменённые сегменты проходят не дальше допуска от всех
+         * положений, пройденных с их начала, иначе в положении указателя фиксируется новая точка. Если новая точка
+         * уводит от положений предыдущий сегмент, эти положения сами становятся точками кривой. Положения ближе десятой
+         * доли допуска к предыдущему не учитываются, а на сегмент приходится не больше maxStrokeSamples положений,
+         * поэтому обработка обычно занимает постоянное время; вставка точек в середину штриха перестраивает кэши за O(N).
+         * Если точки кривой изменились во время штриха, штрих завершается.
+         * @param point Положение указателя.
+         */
+        void ContinueStroke(const ImVec2& point);
+        /**
+         * Завершает штрих, оставляя последнюю точку в текущем положении.
+         */
+        void EndStroke() { stroke.active = false; }
+        /**
+         * Проверяет, идёт ли рисование штриха.
+         * @return Логическое значение, указывающее, начат ли штрих (true) или нет (false).
+         */
+        bool IsStroking() const { return stroke.active; }
         /**
          * Отображает кривую Безье и её точки.
          * @param editable Доступеность для редактирования, если значение равно true, точки на кривой можно перетаскивать.
          */
         void Draw(bool editable = true);
         /**
-         * Проверяет пересекает ли кривая сама себя
+         * Отображает кривую Безье и её точки относительно верхней зоны заданного экземпляра ZoneMapper.
+         * @param zones Экземпляр ZoneMapper, задающий зону кривой.
+         * @param editable Доступеность для редактирования, если значение равно true, точки на кривой можно перетаскивать.
+         */
+        void Draw(const ZoneMapper& zones, bool editable = true);
+        /**
+         * Отображает кривую Безье в заданный список отрисовки без точек и без обращения к контексту ImGui.
+         * Может вызываться одновременно из нескольких потоков для разных кривых и списков отрисовки,
+         * например для построения миниатюр на внеэкранных холстах. ImGui пишет во временный буфер ImDrawListSharedData,
+         * поэтому списки отрисовки разных потоков должны ссылаться на разные экземпляры общих данных.
+         * @param drawList Список отрисовки, в который добавляется кривая.
+         * @param zones Экземпляр ZoneMapper, задающий зону кривой.
+         */
+        void Draw(ImDrawList* drawList, const ZoneMapper& zones);
+        /**
+         * Проверяет пересекает ли кривая сама себя, то есть пересекаются ли несмежные звенья ломаной по её выборке
+         * BezierGeometry::IntersectionSampleCount(): ломаная обрывается в последней точке выборки и не замыкается.
+         * Пары пересекающихся звеньев хранятся между вызовами. После перемещения точки, добавления точки в конец
+         * или удаления последней точки заново проверяются только звенья четырёх затронутых сегментов, и время вызова
+         * зависит от их числа и соседей по сетке, а не от длины кривой. Вставка и удаление точки в середине, Simplify(),
+         * изменение замкнутости и присваивание перестраивают индекс заново за время, пропорциональное числу звеньев.
          * @return Логическое значение, указывающее, пересекает ли кривая сама себя (true) или нет (false).
          */
         bool IsSelfIntersecting();
+        /**
+         * Предоставляет точки самопересечения кривой.
+         * @return Ссылка на точки пересечения несмежных звеньев ломаной по выборке кривой в координатах зоны,
+         * действительная до следующего изменения кривой. Для кривой меньше чем из трёх точек список пуст.
+         */
+        const std::vector<ImVec2>& GetIntersectionPoints();
         /**
          * Определяет индекс точки, расположенной рядом с указателем мыши.
          * @param threshold Порог приближения для выбора точки.
          * @return Индекс точки, расположенной рядом с указателем мыши.
          */
         size_t dotIndex(float threshold = 5.0f);
+        /**
+         * Определяет индекс точки, расположенной рядом с указателем мыши, относительно верхней зоны заданного экземпляра ZoneMapper.
+         * @param zones Экземпляр ZoneMapper, задающий зону кривой.
+         * @param threshold Порог приближения для выбора точки.
+         * @return Индекс точки, расположенной рядом с указателем мыши.
+         */
+        size_t dotIndex(const ZoneMapper& zones, float threshold = 5.0f);
+        /**
+         * Упрощает кривую, удаляя точки, без которых она остаётся в пределах заданного отклонения от исходной.
+         * Начальный набор точек выбирается алгоритмом Рамера-Дугласа-Пекера, затем упрощённая кривая
+         * строится по тому же правилу касательных, что и исходная, и на участках с превышением отклонения точки возвращаются.
+         * Отклонение проверяется в обе стороны по выборке сегментов: исходная кривая не дальше допуска от упрощённой, и наоборот.
+         * @param tolerance Допустимое расстояние между упрощённой и исходной кривой в обе стороны.
+         * @return Коэффициент сокращения: отношение исходного числа точек к итоговому.
+         */
+        float Simplify(float tolerance = 1.0f);
+        /**
+         * Предоставляет число сегментов кривой.
+         * @return Число кубических сегментов между точками кривой.
+         */
+        size_t GetSegmentCount() const { return points.size() < 2 ? 0 : points.size() - !isClosed; }
+        /**
+         * Предоставляет точный ограничивающий прямоугольник кривой в координатах зоны.
+         * Границы сегментов находятся аналитически по корням производной и кэшируются вместе с контрольными точками.
+         * @return Ограничивающий прямоугольник кривой, пустой для кривой без точек.
+         */
+        BoundingBox GetBounds();
+        /**
+         * Предоставляет точный ограничивающий прямоугольник сегмента кривой в координатах зоны.
+         * @param i Индекс сегмента.
+         * @return Ограничивающий прямоугольник сегмента, пустой для несуществующего сегмента.
+         */
+        BoundingBox GetSegmentBounds(size_t i);
+        /**
+         * Предоставляет ограничивающие прямоугольники всех сегментов кривой.
+         * @return Ссылка на кэш прямоугольников, действительная до следующего изменения кривой.
+         */
+        const std::vector<BoundingBox>& GetSegmentBounds();
+        /**
+         * Проверяет, лежит ли точка внутри замкнутой кривой, по ненулевому числу оборотов.
+         * Сначала проверяется ограничивающий прямоугольник, затем только звенья аппроксимирующей ломаной,
+         * попавшие в горизонтальную полосу точки. Разбиение звеньев по полосам кэшируется до изменения кривой.
+         * @param point Точка в координатах зоны.
+         * @return Логическое значение, указывающее, лежит ли точка внутри кривой (true) или нет (false). Для незамкнутой кривой всегда false.
+         */
+        bool IsPointInside(const ImVec2& point);
+        /**
+         * Вычисляет площадь области, ограниченной замкнутой кривой.
+         * Площадь находится по формуле Грина непосредственно по кубическим сегментам, без аппроксимации ломаной.
+         * @return Площадь области. Для незамкнутой кривой 0.
+         */
+        float GetArea();
+        /**
+         * Вычисляет центр масс области, ограниченной замкнутой кривой.
+         * @return Центр масс области в координатах зоны. Для кривой нулевой площади - центр ограничивающего прямоугольника.
+         */
+        ImVec2 GetCentroid();
 
         /**
          * Удаляет все точки с кривой.
          */
-        void Clear() { points.clear(); }
+        void Clear() { points.clear(); geometry.valid = false; }
         /**
          * Удаляет точку с кривой по ее индексу.
+         * Удаление последней точки обновляет кэши только у соседних сегментов, удаление другой точки перестраивает их заново.
          * @param index Индекс удаляемой точки.
          */
-        void DeletePoint(size_t index) { if (index < points.size()) points.erase(points.begin() + index); }
+        void DeletePoint(size_t index);
+        /**
+         * Перемещает точку кривой по ее индексу.
+         * Кэши обновляются только у сегментов, зависящих от перемещённой точки.
+         * @param index Индекс перемещаемой точки.
+         * @param pos Новое положение точки в координатах зоны.
+         */
+        void MovePoint(size_t index, const ImVec2& pos);
 
         /**
          * Устанавливает признак заскнутости кривой
@@ -94,6 +221,22 @@ namespace ImGui {
          * @param tic Толщина кривой.
          */
         void SetThickness(const float& tic) { thickness = tic; }
+        /**
+         * Устанавливает признак заливки области замкнутой кривой.
+         * @param fill Логическое значение, указывающее, заливается ли область замкнутой кривой (true) или нет (false).
+         */
+        void SetFilled(const bool& fill) { isFilled = fill; }
+        /**
+         * Задает цвет заливки.
+         * @param col Цвет заливки.
+         */
+        void SetFillColor(const ImU32& col) { fillColor = col; }
+        /**
+         * Устанавливает способ построения обводки.
+         * @param batched Логическое значение: true - вся кривая выводится одной ломаной с соединениями на стыках сегментов,
+         * false - каждый сегмент выводится отдельным вызовом AddBezierCubic.
+         */
+        void SetBatchedStroke(const bool& batched) { batchedStroke = batched; }
 
         /**
          * Предоставляет указатель на свойство замкнутости кривой, позволяющее напрямую изменять его.
@@ -110,6 +253,21 @@ namespace ImGui {
          * @return Указатель на толщину кривой.
          */
         float* GetThickness() { return &thickness; }
+        /**
+         * Предоставляет указатель на признак заливки, позволяющее напрямую изменять его.
+         * @return Указатель на логический признак заливки области кривой.
+         */
+        bool* GetFilled() { return &isFilled; }
+        /**
+         * Предоставляет указатель на цвет заливки, позволяющее напрямую изменять его.
+         * @return Указатель на цвет заливки.
+         */
+        ImU32* GetFillColor() { return &fillColor; }
+        /**
+         * Предоставляет указатель на способ построения обводки, позволяющее напрямую изменять его.
+         * @return Указатель на логический признак вывода обводки одной ломаной.
+         */
+        bool* GetBatchedStroke() { return &batchedStroke; }
         /**
          * Преобразует кривую в строку.
          * @return Строка содержащая сериализованную кривую.
@@ -118,59 +276,166 @@ namespace ImGui {
         /**
          * Преобразует строку в кривую.
          * @param data Данные кривой.
-         * @return Десериализованная кривая.
+         * @return Десериализованная кривая или пустая кривая, если данные повреждены.
          */
         static DraggableBezierCurve Deserialize(const std::string& data);
+        /**
+         * Преобразует строку в кривую с проверкой данных.
+         * Строка должна содержать три поля заголовка и по четыре поля на каждую точку, все числа конечны.
+         * @param data Данные кривой.
+         * @param curve Кривая, в которую записывается результат. При ошибке в неё записывается пустая кривая.
+         * @return Логическое значение, указывающее, корректны ли данные (true) или нет (false).
+         */
+        static bool TryDeserialize(const std::string& data, DraggableBezierCurve& curve);
     private:
         ImU32 color; ///< Цвет кривой.
         float thickness; ///< Толщина кривой.
         bool isClosed; ///< Замкнутость кривой.
+        bool isFilled = false; ///< Заливка области замкнутой кривой.
+        ImU32 fillColor = IM_COL32(255, 0, 0, 96); ///< Цвет заливки.
+        bool batchedStroke = true; ///< Вывод обводки одной ломаной вместо отдельного вызова на каждый сегмент.
         std::vector<DraggableDot> points; ///< Точки, составляющие кривую.
+
+        /**
+         * @brief Состояние рисования кривой от руки.
+         * Точки штриха стоят в учтённых положениях указателя, а положения между точками k и k + 1 проверяются
+         * по сегменту между ними.
+         */
+        struct StrokeState {
+            bool active = false; ///< Признак начатого штриха.
+            float tolerance = 0.0f; ///< Допустимое отклонение.
+            float radius = 0.0f; ///< Радиус добавляемых точек.
+            ImU32 color = 0; ///< Цвет добавляемых точек.
+            size_t first = 0; ///< Индекс первой точки штриха в кривой.
+            std::vector<ImVec2> samples; ///< Учтённые положения указателя.
+            std::vector<size_t> knotSamples; ///< Номера положений, в которых стоят точки штриха.
+            std::vector<ImVec2> window; ///< Рабочий буфер соседних точек проверяемого сегмента.
+            std::vector<ImVec2> polyline; ///< Рабочий буфер ломаной проверяемого сегмента.
+        };
+
+        static constexpr size_t maxStrokeSamples = 64; ///< Наибольшее число положений указателя на сегмент штриха.
+
+        StrokeState stroke; ///< Состояние рисования кривой от руки.
+
         /**
-         * Вычисляет контрольные точки для заданного сегмента кривой.
-         * @param i Индекс текущей точки в векторе точек.
-         * @param cp1 Ссылка на первую контрольную точку, которая должна быть рассчитана.
-         * @param cp2 Ссылка на вторую контрольную точку, которая должна быть рассчитана.
+         * @brief Кэш геометрии кривой.
+         * Хранит положения точек, по которым он построен, и перестраивается только для сегментов, зависящих от точек,
+         * отмеченных как перемещённые, и от точек в конце кривой при изменении их числа. Любое другое изменение
+         * точек сбрасывает признак valid, и кэш строится заново.
          */
-        void CalculateControlPoints(size_t i, ImVec2& cp1, ImVec2& cp2);
+        struct GeometryCache {
+            bool valid = false; ///< Признак построенного кэша.
+            bool closed = false; ///< Замкнутость кривой, для которой построен кэш.
+            std::vector<ImVec2> knots; ///< Положения точек, для которых построен кэш.
+            std::vector<ImVec2> controls; ///< Контрольные точки, по две на сегмент.
+            std::vector<BoundingBox> segmentBounds; ///< Ограничивающие прямоугольники сегментов.
+            std::vector<BoundingBox> boundsTree; ///< Дерево объединений прямоугольников сегментов: узел i объединяет узлы 2i и 2i + 1, листья - во второй половине.
+            BoundingBox bounds; ///< Ограничивающий прямоугольник кривой.
+            int steps = 1; ///< Число звеньев ломаной на сегмент.
+            std::vector<ImVec2> flattened; ///< Аппроксимирующая ломаная: по steps вершин на сегмент и конечная точка незамкнутой кривой.
+            unsigned int revision = 0; ///< Номер версии, увеличивается при каждом изменении кэша.
+            std::vector<unsigned int> changedSegments; ///< Сегменты, пересчитанные после последнего обновления индекса пересечений.
+            bool changedAll = true; ///< Признак изменения, после которого индекс пересечений строится заново.
+            std::vector<unsigned int> movedKnots; ///< Точки, перемещённые после последнего обновления кэша.
+        };
 
-        const float increment = 0.05f; ///< Приращение, используемое для выборки кривой Безье.
+        /**
+         * @brief Кэш запросов к области, ограниченной замкнутой кривой.
+         * Строится по кэшу геометрии при первом запросе после изменения кривой.
+         */
+        struct RegionCache {
+            bool valid = false; ///< Признак построенного кэша.
+            unsigned int revision = 0; ///< Версия кэша геометрии, по которой построен кэш.
+            float area = 0.0f; ///< Площадь области.
+            ImVec2 centroid; ///< Центр масс области.
+            float bandTop = 0.0f; ///< Верхняя граница первой полосы.
+            float bandHeight = 1.0f; ///< Высота полосы.
+            std::vector<unsigned int> bandStart; ///< Начало списка звеньев каждой полосы в bandEdges, на одно значение больше числа полос.
+            std::vector<unsigned int> bandEdges; ///< Индексы звеньев ломаной, пересекающих полосы.
+        };
+
+        /**
+         * @brief Кэш триангуляции области замкнутой кривой.
+         * Треугольники задаются индексами вершин аппроксимирующей ломаной и перестраиваются только при изменении кривой.
+         */
+        struct FillCache {
+            bool valid = false; ///< Признак построенного кэша.
+            unsigned int revision = 0; ///< Версия кэша геометрии, по которой построен кэш.
+            std::vector<unsigned int> triangles; ///< Индексы вершин, по три на треугольник.
+        };
 
         /**
-         * Вычисляет ближайшую точку на отрезке прямой, заданном символами "a" и "b", к заданной точке "p".
-         * @param a Начальная точка отрезка прямой.
-         * @param b Конечная точка отрезка прямой.
-         * @param p Точка, к которой ищется ближайшая точка на отрезке прямой.
-         * @return Координаты точки.
+         * @brief Кэш самопересечений кривой.
+         * Индекс звеньев аппроксимирующей ломаной обновляется по списку сегментов, пересчитанных в кэше геометрии.
+         */
+        struct IntersectionCache {
+            bool valid = false; ///< Признак построенного индекса.
+            BezierGeometry::IntersectionIndex index; ///< Индекс пересекающихся пар звеньев.
+            std::vector<unsigned int> edges; ///< Звенья, переданные в последнее обновление индекса.
+            size_t builtEdges = 0; ///< Число звеньев при последнем построении индекса заново.
+        };
+
+        GeometryCache geometry; ///< Кэш геометрии кривой.
+        RegionCache region; ///< Кэш запросов к области кривой.
+        FillCache fill; ///< Кэш триангуляции области кривой.
+        IntersectionCache intersections; ///< Кэш самопересечений кривой.
+
+        /**
+         * Отмечает перемещение точки для следующего обновления кэша геометрии.
+         * @param i Индекс перемещённой точки.
+         */
+        void KnotMoved(size_t i);
+        /**
+         * Приводит кэш геометрии в соответствие с текущими точками кривой.
+         * Пересчитываются только сегменты, зависящие от перемещённых точек и от точек в конце кривой при изменении их числа,
+         * а ограничивающий прямоугольник кривой обновляется по дереву объединений за логарифмическое время на сегмент.
+         * @return Ссылка на актуальный кэш геометрии.
+         */
+        const GeometryCache& UpdateGeometry();
+        /**
+         * Пересчитывает контрольные точки и ограничивающий прямоугольник сегмента в кэше геометрии.
+         * @param i Индекс сегмента.
+         */
+        void UpdateSegment(size_t i);
+        /**
+         * Заменяет лист дерева объединений прямоугольников и пересчитывает узлы на пути к корню.
+         * @param i Индекс листа.
+         * @param box Новый прямоугольник листа.
+         */
+        void UpdateBoundsTree(size_t i, const BoundingBox& box);
+        /**
+         * Приводит кэш запросов к области в соответствие с кэшем геометрии.
+         * @return Ссылка на актуальный кэш запросов к области.
+         */
+        const RegionCache& UpdateRegion();
+        /**
+         * Приводит индекс пересечений в соответствие с кэшем геометрии.
+         * Если с прошлого обновления изменились только отдельные сегменты, перепроверяются лишь их звенья,
+         * а звенья в конце ломаной добавляются или удаляются. Индекс строится заново после полной перестройки кэша геометрии
+         * и когда число звеньев вдвое превысило число при последнем построении, чтобы размер ячеек соответствовал ломаной.
+         * @return Ссылка на актуальный индекс пересечений.
          */
-        static inline ImVec2 ClosestPointOnLine(const ImVec2& a, const ImVec2& b, const ImVec2& p);
+        BezierGeometry::IntersectionIndex& UpdateIntersections();
         /**
-         * Вычисляет точку на кубической кривой Безье.
-         * @param t Параметр, указывающее точку на кривой, которую необходимо вычислить.
-         * @param p0 Первая контрольная точка кубической кривой Безье.
-         * @param p1 Вторая контрольная точка кубической кривой Безье.
-         * @param p2 Третья контрольная точка кубической кривой Безье.
-         * @param p3 Четвертая контрольная точка кубической кривой Безье.
-         * @return Координаты точки на кривой Безье.
+         * Заливает область замкнутой кривой треугольниками из кэша триангуляции.
+         * При 16-битных индексах заливка, не умещающаяся в них, выводится частями; без флага ImDrawListFlags_AllowVtxOffset
+         * у списка отрисовки выводится только то, что умещается в оставшиеся индексы.
+         * @param drawList Список отрисовки, в который добавляется заливка.
+         * @param offset Смещение, добавляемое к координатам вершин.
          */
-        static inline ImVec2 CalculateBezierPoint(float t, ImVec2 p0, ImVec2 p1, ImVec2 p2, ImVec2 p3);
+        void DrawFill(ImDrawList* drawList, const ImVec2& offset);
         /**
-         * Определяет, лежит ли точка 'q' на отрезке прямой 'pr'.
-         * @param p Начальная точка отрезка прямой.
-         * @param q Проверяемая точка.
-         * @param r Конечная точка отрезка прямой.
-         * @return Логическое значение, указывающее, лежит ли точка 'q' на отрезке прямой 'pr' (true) или нет (false).
+         * Проверяет, что положения указателя между точками штриха k и k + 1 лежат не дальше допуска от сегмента между ними.
+         * @param k Номер точки штриха, с которой начинается сегмент.
+         * @return Логическое значение, указывающее, укладываются ли положения в допуск (true) или нет (false).
          */
-        static inline bool onSegment(ImVec2 p, ImVec2 q, ImVec2 r);
+        bool StrokeSegmentFits(size_t k);
         /**
-         * Проверяет, пересекаются ли два отрезка прямой ('p1q1' и 'p2q2').
-         * @param p1 Начальная точка первого отрезка прямой.
-         * @param q1 Конечная точка первого отрезка прямой.
-         * @param p2 Начальная точка второго отрезка прямой.
-         * @param q2 Конечная точка второго отрезка прямой.
-         * @return Логическое значение, указывающее, пересекаются ли отрезки (true) или нет (false).
+         * Делает точками кривой положения указателя на сегменте штриха k и так же исправляет соседние сегменты,
+         * которые из-за этого вышли из допуска.
+         * @param k Номер точки штриха, с которой начинается сегмент.
          */
-        static bool SegmentsIntersect(const ImVec2& p1, const ImVec2& q1, const ImVec2& p2, const ImVec2& q2);
+        void SplitStrokeSegment(size_t k);
     };
 
 }
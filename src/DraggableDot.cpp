@@ -14,11 +14,15 @@ namespace ImGui {
         : position(pos), radius(rad), color(col) {}
 
     void DraggableDot::Draw() {
+        Draw(ZoneMapper::Current());
+    }
+
+    void DraggableDot::Draw(const ZoneMapper& zones) {
         ImGuiIO& io = ImGui::GetIO();
         ImDrawList* draw_list = ImGui::GetWindowDrawList();
 
-        ImVec2 zonePos = ZoneMapper::GetZonePos();
-        ImVec2 zoneSize = ZoneMapper::GetZoneSize();
+        ImVec2 zonePos = zones.GetPos();
+        ImVec2 zoneSize = zones.GetSize();
         ImVec2 dotPos = zonePos + position;
 
         ImGui::SetCursorScreenPos(dotPos - radius);
@@ -38,6 +38,11 @@ namespace ImGui {
          *       ,   ,      .
          */
         void Draw();
+        /**
+         *      ImGui      ZoneMapper.
+         * @param zones  ZoneMapper,   .
+         */
+        void Draw(const ZoneMapper& zones);
 
         /**
          *    .
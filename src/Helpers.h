@@ -51,7 +51,7 @@ static inline float Len(const ImVec2& v) { return std::sqrt(v.x * v.x + v.y * v.
  * @param  .
  * @return    .
  */
-static inline float DotProduct(const ImVec2& a, const ImVec2& b) { return std::sqrt(a.x * b.x + a.y * b.y); }
+static inline float DotProduct(const ImVec2& a, const ImVec2& b) { return a.x * b.x + a.y * b.y; }
 /**
  *      ImVec2.
  * @param a  .
@@ -10,29 +10,42 @@
 
 namespace ImGui {
 
-    std::vector<ZoneMapper::ZoneData> ZoneMapper::zoneStack;
+    thread_local ZoneMapper* ZoneMapper::current = nullptr;
 
     ZoneMapper::ZoneMapper() {}
 
-    void ZoneMapper::BeginZone() {
+    void ZoneMapper::Begin() {
+        Begin(ImGui::GetCursorScreenPos(), ImGui::GetContentRegionAvail());
+    }
+
+    void ZoneMapper::Begin(const ImVec2& pos, const ImVec2& size) {
         ZoneData zone;
-        zone.position = ImGui::GetCursorScreenPos();
-        zone.size = ImGui::GetContentRegionAvail();
+        zone.position = pos;
+        zone.size = size;
         zoneStack.push_back(zone);
     }
 
-    void ZoneMapper::EndZone() {
-        zoneStack.pop_back();
+    void ZoneMapper::End() {
+        if (!zoneStack.empty()) zoneStack.pop_back();
     }
 
-    ImVec2 ZoneMapper::GetZonePos() {
+    ImVec2 ZoneMapper::GetPos() const {
         if (!zoneStack.empty()) return zoneStack.back().position;
         else return ImVec2(0, 0);
     }
 
-    ImVec2 ZoneMapper::GetZoneSize() {
+    ImVec2 ZoneMapper::GetSize() const {
         if (!zoneStack.empty()) return zoneStack.back().size;
         else return ImVec2(0, 0);
     }
 
+    ZoneMapper& ZoneMapper::Current() {
+        static thread_local ZoneMapper threadMapper;
+        return current ? *current : threadMapper;
+    }
+
+    void ZoneMapper::SetCurrent(ZoneMapper* mapper) {
+        current = mapper;
+    }
+
 }
@@ -18,6 +18,7 @@ namespace ImGui {
      * @brief       ImGui.
      * ZoneMapper       ImGui   ,
      *          .
+     *     ,        .
      */
     class ZoneMapper {
     public:
@@ -27,25 +28,64 @@ namespace ImGui {
         ZoneMapper();
 
         /**
-         *      . 
+         *         ImGui.
+         *        End().
+         */
+        void Begin();
+        /**
+         *          .
+         *     ImGui,        .
+         * @param pos     .
+         * @param size  .
+         */
+        void Begin(const ImVec2& pos, const ImVec2& size);
+        /**
+         *   ,   Begin().
+         */
+        void End();
+        /**
+         *      .
+         * @return       (0, 0),   .
+         */
+        ImVec2 GetPos() const;
+        /**
+         *      .
+         * @return    (0, 0),   .
+         */
+        ImVec2 GetSize() const;
+
+        /**
+         *    ZoneMapper  .
+         *       ,      ImGui    .
+         * @return    .
+         */
+        static ZoneMapper& Current();
+        /**
+         *      .
+         * @param mapper ,     ,  nullptr       .
+         */
+        static void SetCurrent(ZoneMapper* mapper);
+
+        /**
+         *         .
          *        EndZone().
          */
-        static void BeginZone();
+        static void BeginZone() { Current().Begin(); }
         /**
-        *      . 
+        *         .
         *     BeginZone().
         */
-        static void EndZone();
+        static void EndZone() { Current().End(); }
         /**
          *    .
          * @return         ImVec2.
          */
-        static ImVec2 GetZonePos();
+        static ImVec2 GetZonePos() { return Current().GetPos(); }
         /**
          *    .
          * @return      ImVec2.
          */
-        static ImVec2 GetZoneSize();
+        static ImVec2 GetZoneSize() { return Current().GetSize(); }
 
     private:
         struct ZoneData {
@@ -53,7 +93,9 @@ namespace ImGui {
             ImVec2 size; ///<  .
         };
 
-        static std::vector<ZoneData> zoneStack; ///<  ,   .
+        std::vector<ZoneData> zoneStack; ///<  ,   .
+
+        static thread_local ZoneMapper* current; ///< ,    ,  nullptr.
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,590 @@
+#include "TestHelpers.h"
+#include "ReferenceGeometry.h"
+
+#include <imgui_internal.h>
+#include <map>
+#include <random>
+
+/**
+ * @file GeometryTests.cpp
+ * Файл, содержащий детерминированные случайные тесты, сравнивающие геометрию и разбор строк с эталонными реализациями
+ * @brief Тесты геометрии кривых
+ */
+
+using ImGui::DraggableBezierCurve;
+using ImGui::BoundingBox;
+namespace BezierGeometry = ImGui::BezierGeometry;
+
+/**
+ * @brief Генератор случайных данных с фиксированным начальным значением.
+ */
+struct Random {
+    std::mt19937 engine; ///< Генератор.
+
+    explicit Random(unsigned int seed) : engine(seed) {}
+    int Integer(int low, int high) { return std::uniform_int_distribution<int>(low, high)(engine); }
+    float Real(float low, float high) { return std::uniform_real_distribution<float>(low, high)(engine); }
+    ImVec2 Point(int low, int high) { return ImVec2((float)Integer(low, high), (float)Integer(low, high)); }
+};
+
+static std::vector<Reference::Vec> ToReference(const std::vector<ImVec2>& knots) {
+    std::vector<Reference::Vec> result;
+    for (const ImVec2& knot : knots) result.push_back({ knot.x, knot.y });
+    return result;
+}
+
+/**
+ * Сравнивает SegmentsIntersect с точным решением на целочисленных координатах, при которых вычисления в float точны,
+ * включая касания, коллинеарные и вырожденные отрезки.
+ */
+static void TestSegmentsIntersect() {
+    Random random(1);
+    for (int trial = 0; trial < 200000; trial++) {
+        int range = (trial % 2) ? 4 : 1000;
+        ImVec2 p1 = random.Point(-range, range), q1 = random.Point(-range, range);
+        ImVec2 p2 = random.Point(-range, range), q2 = random.Point(-range, range);
+
+        bool expected = Reference::SegmentsIntersectExact((long long)p1.x, (long long)p1.y, (long long)q1.x, (long long)q1.y, (long long)p2.x, (long long)p2.y, (long long)q2.x, (long long)q2.y);
+        bool actual = BezierGeometry::SegmentsIntersect(p1, q1, p2, q2);
+        CHECK(actual == expected, "(%g,%g)-(%g,%g) x (%g,%g)-(%g,%g): expected %d", p1.x, p1.y, q1.x, q1.y, p2.x, p2.y, q2.x, q2.y, expected);
+    }
+}
+
+/**
+ * Сравнивает IsSelfIntersecting с перебором всех пар звеньев выборки в двойной точности.
+ */
+static void TestIsSelfIntersecting() {
+    Random random(2);
+    int decided = 0;
+    for (int trial = 0; trial < 600; trial++) {
+        bool closed = trial % 2;
+        std::vector<ImVec2> knots;
+        for (int i = random.Integer(2, 12); i > 0; i--) knots.push_back(random.Point(0, 800));
+
+        Reference::Verdict expected = Reference::SelfIntersection(ToReference(knots), closed, 1e-2);
+        if (expected == Reference::Verdict::Ambiguous) continue;
+        decided++;
+
+        DraggableBezierCurve curve = CurveFromKnots(knots, closed);
+        CHECK(curve.IsSelfIntersecting() == (expected == Reference::Verdict::True), "trial %d, %zu points, closed %d", trial, knots.size(), closed);
+    }
+    CHECK(decided > 400, "only %d of 600 curves had an unambiguous reference verdict", decided);
+}
+
+/**
+ * Перетаскивает точки кривой и сравнивает поддерживаемые при перемещениях пересечения, ограничивающий прямоугольник
+ * и площадь с кривой, построенной заново. Перемещения чередуются со штрихами, добавлением и удалением точек в конце,
+ * которые обновляют кэши на месте, и со вставкой, удалением в середине и сменой замкнутости, которые их перестраивают.
+ */
+static void TestIncrementalIntersections() {
+    Random random(5);
+    for (int trial = 0; trial < 40; trial++) {
+        bool closed = trial % 2;
+        std::vector<ImVec2> knots;
+        for (int i = random.Integer(3, 80); i > 0; i--) knots.push_back(random.Point(0, 800));
+        DraggableBezierCurve curve = CurveFromKnots(knots, closed);
+
+        for (int step = 0; step < 150; step++) {
+            int action = random.Integer(0, 19);
+            if (action == 0) curve.AddPoint(random.Point(0, 800), 20.0f);
+            else if (action == 1 && knots.size() > 3) curve.DeletePoint(random.Integer(0, (int)knots.size() - 1));
+            else if (action == 2 && step % 10 == 0) curve.SetClosed(closed = !closed);
+            else if (action == 3) curve.AddPoint(knots.back() + random.Point(-60, 60), 0.0f);
+            else if (action == 4 && knots.size() > 3) curve.DeletePoint(knots.size() - 1);
+            else if (action == 5) {
+                // Штрих почти по прямой: последняя точка следует за указателем, а кэш запрашивается посреди штриха.
+                ImVec2 start = knots.back() + random.Point(-30, 30), direction = random.Point(-4, 4);
+                curve.BeginStroke(start, 2.0f);
+                for (int i = 1; i <= 30; i++) {
+                    curve.ContinueStroke(start + direction * (float)i + random.Point(-1, 1));
+                    if (random.Integer(0, 3) == 0) curve.GetBounds();
+                }
+                curve.EndStroke();
+            }
+            else {
+                size_t index = random.Integer(0, (int)knots.size() - 1);
+                ImVec2 offset = action < 10 ? random.Point(-20, 20) : random.Point(-300, 300);
+                curve.MovePoint(index, knots[index] + offset);
+            }
+            knots = CurveKnots(curve);
+
+            // Несколько изменений подряд без запросов копятся в кэше и проверяются вместе.
+            if (random.Integer(0, 2) == 0) continue;
+
+            DraggableBezierCurve fresh = CurveFromKnots(knots, closed);
+            const std::vector<ImVec2>& actual = curve.GetIntersectionPoints();
+            const std::vector<ImVec2>& expected = fresh.GetIntersectionPoints();
+            bool same = actual.size() == expected.size();
+            for (size_t i = 0; same && i < actual.size(); i++) same = actual[i].x == expected[i].x && actual[i].y == expected[i].y;
+            CHECK(same, "trial %d, step %d: %zu intersection points, expected %zu", trial, step, actual.size(), expected.size());
+            CHECK(curve.IsSelfIntersecting() == fresh.IsSelfIntersecting(), "trial %d, step %d: intersection flag differs", trial, step);
+
+            BoundingBox bounds = curve.GetBounds(), freshBounds = fresh.GetBounds();
+            CHECK(bounds.Min.x == freshBounds.Min.x && bounds.Min.y == freshBounds.Min.y && bounds.Max.x == freshBounds.Max.x && bounds.Max.y == freshBounds.Max.y,
+                "trial %d, step %d: bounds (%g,%g)-(%g,%g), expected (%g,%g)-(%g,%g)", trial, step,
+                bounds.Min.x, bounds.Min.y, bounds.Max.x, bounds.Max.y, freshBounds.Min.x, freshBounds.Min.y, freshBounds.Max.x, freshBounds.Max.y);
+            CHECK(curve.GetArea() == fresh.GetArea(), "trial %d, step %d: area %g, expected %g", trial, step, curve.GetArea(), fresh.GetArea());
+        }
+    }
+}
+
+/**
+ * Сравнивает место вставки точки в AddPoint с эталонным поиском ближайшей точки выборки.
+ */
+static void TestAddPoint() {
+    Random random(3);
+    int decided = 0;
+    for (int trial = 0; trial < 3000; trial++) {
+        bool closed = trial % 2;
+        std::vector<ImVec2> knots;
+        for (int i = random.Integer(0, 10); i > 0; i--) knots.push_back(random.Point(0, 800));
+        ImVec2 point = random.Point(0, 800);
+        float threshold = (float)random.Integer(5, 60);
+
+        long long expected = Reference::InsertIndex(ToReference(knots), closed, { point.x, point.y }, threshold, 1e-2);
+        if (expected < 0) continue;
+        decided++;
+
+        DraggableBezierCurve curve = CurveFromKnots(knots, closed);
+        curve.AddPoint(point, threshold);
+
+        std::vector<ImVec2> actual = CurveKnots(curve);
+        knots.insert(knots.begin() + expected, point);
+        bool same = actual.size() == knots.size();
+        for (size_t i = 0; same && i < knots.size(); i++) same = actual[i].x == knots[i].x && actual[i].y == knots[i].y;
+        CHECK(same, "trial %d: point (%g,%g) expected at index %lld", trial, point.x, point.y, expected);
+    }
+    CHECK(decided > 2500, "only %d of 3000 insertions had an unambiguous reference index", decided);
+}
+
+/**
+ * Строит случайную кривую, похожую на нарисованную от руки: плавный поворот направления и мелкое дрожание.
+ * Координаты кратны 0.25, чтобы без потерь проходить через сериализацию.
+ */
+static std::vector<ImVec2> WobblyKnots(Random& random, int count) {
+    std::vector<ImVec2> knots;
+    ImVec2 position = random.Point(300, 500);
+    float heading = random.Real(0.0f, 6.2831853f), turn = random.Real(-0.3f, 0.3f);
+    for (int i = 0; i < count; i++) {
+        float step = random.Real(2.0f, 12.0f), jitter = random.Real(-1.5f, 1.5f);
+        heading += turn + random.Real(-0.2f, 0.2f);
+        position = position + ImVec2(std::cos(heading) * step - std::sin(heading) * jitter, std::sin(heading) * step + std::cos(heading) * jitter);
+        knots.push_back(ImVec2(std::round(position.x * 4.0f) / 4.0f, std::round(position.y * 4.0f) / 4.0f));
+    }
+    return knots;
+}
+
+/**
+ * Проверяет, что Simplify сохраняет часть исходных точек, включая концы незамкнутой кривой,
+ * и что упрощённая кривая отстоит от исходной не дальше допуска в обе стороны.
+ */
+static void TestSimplify() {
+    Random random(6);
+    size_t before = 0, after = 0;
+    for (int trial = 0; trial < 300; trial++) {
+        bool closed = trial % 2;
+        float tolerance = random.Integer(1, 8) * 0.5f;
+        std::vector<ImVec2> knots = WobblyKnots(random, random.Integer(3, 80));
+
+        DraggableBezierCurve curve = CurveFromKnots(knots, closed);
+        curve.Simplify(tolerance);
+        std::vector<ImVec2> simplified = CurveKnots(curve);
+        before += knots.size();
+        after += simplified.size();
+
+        size_t matched = 0;
+        for (size_t i = 0; i < knots.size() && matched < simplified.size(); i++)
+            if (knots[i].x == simplified[matched].x && knots[i].y == simplified[matched].y) matched++;
+        CHECK(matched == simplified.size(), "trial %d: simplified points are not a subsequence of the original", trial);
+        if (!closed) CHECK(simplified.front().x == knots.front().x && simplified.front().y == knots.front().y &&
+            simplified.back().x == knots.back().x && simplified.back().y == knots.back().y, "trial %d: open curve lost an end point", trial);
+
+        std::vector<Reference::Vec> original = Reference::Outline(ToReference(knots), closed);
+        std::vector<Reference::Vec> result = Reference::Outline(ToReference(simplified), closed);
+        double forward = Reference::Deviation(original, result), backward = Reference::Deviation(result, original);
+        CHECK(forward <= tolerance + 1e-2, "trial %d: original is %g from simplified curve, tolerance %g", trial, forward, tolerance);
+        CHECK(backward <= tolerance + 1e-2, "trial %d: simplified curve is %g from original, tolerance %g", trial, backward, tolerance);
+    }
+    CHECK(after * 2 < before, "simplification kept %zu of %zu points", after, before);
+}
+
+/**
+ * Рисует кривые от руки по неровному пути и по пути с резкими поворотами и проверяет, что каждое положение указателя
+ * лежит не дальше допуска от ломаной отображаемой кривой. На неровном пути точек должно быть меньше 60% положений,
+ * на пути с поворотами в каждом положении - меньше, чем положений.
+ */
+static void TestStroke() {
+    Random random(7);
+    size_t positions[2] = {}, knots[2] = {};
+    for (int trial = 0; trial < 400; trial++) {
+        bool turns = trial % 4 == 3;
+        float tolerance = random.Integer(1, 8) * 0.5f;
+        std::vector<ImVec2> path;
+        if (turns) {
+            ImVec2 position = random.Point(200, 600);
+            for (int i = random.Integer(2, 300); i > 0; i--) {
+                path.push_back(position);
+                position = position + ImVec2((float)random.Integer(-12, 12), (float)random.Integer(-12, 12));
+            }
+        }
+        else {
+            path = WobblyKnots(random, random.Integer(2, 300));
+            for (ImVec2& position : path) position = position + ImVec2((float)random.Integer(-8, 8), (float)random.Integer(-8, 8)) * 0.25f;
+        }
+
+        DraggableBezierCurve curve;
+        curve.BeginStroke(path[0], tolerance);
+        for (size_t i = 1; i < path.size(); i++) curve.ContinueStroke(path[i]);
+        curve.EndStroke();
+
+        std::vector<ImVec2> result = CurveKnots(curve);
+        positions[turns] += path.size();
+        knots[turns] += result.size();
+
+        double deviation = Reference::Deviation(ToReference(path), Reference::Outline(ToReference(result), false));
+        CHECK(deviation <= tolerance + 1e-3, "trial %d: pointer path is %g from the drawn curve, tolerance %g", trial, deviation, tolerance);
+        CHECK(result.front().x == path.front().x && result.front().y == path.front().y, "trial %d: stroke does not start at the first position", trial);
+    }
+    CHECK(knots[0] * 5 < positions[0] * 3, "stroke kept %zu knots for %zu positions on wobbly paths", knots[0], positions[0]);
+    CHECK(knots[1] < positions[1], "stroke kept %zu knots for %zu positions on paths with turns", knots[1], positions[1]);
+}
+
+/**
+ * Сравнивает ограничивающие прямоугольники сегментов и всей кривой с плотной выборкой сегментов в двойной точности:
+ * прямоугольник должен содержать все точки выборки и не выходить за её крайние точки больше чем на погрешность.
+ * Среди кривых есть кривые с точками на одной прямой, у которых производная сегмента линейна.
+ */
+static void TestBounds() {
+    Random random(8);
+    for (int trial = 0; trial < 2000; trial++) {
+        bool closed = trial % 2;
+        int range = (trial % 3 == 0) ? 8 : 800;
+        std::vector<ImVec2> knots;
+        for (int i = random.Integer(1, 10); i > 0; i--) knots.push_back(random.Point(0, range));
+        if (trial % 5 == 0) for (ImVec2& knot : knots) knot.y = knot.x * 0.5f;
+
+        DraggableBezierCurve curve = CurveFromKnots(knots, closed);
+        std::vector<Reference::Vec> reference = ToReference(knots);
+        BoundingBox expected;
+        if (knots.size() == 1) expected.Add(knots[0]);
+
+        CHECK(curve.GetSegmentBounds().size() == curve.GetSegmentCount(), "trial %d: %zu segment boxes for %zu segments", trial, curve.GetSegmentBounds().size(), curve.GetSegmentCount());
+        for (size_t i = 0; i < curve.GetSegmentCount(); i++) {
+            Reference::Vec cp1, cp2;
+            Reference::ControlPoints(reference, closed, i, cp1, cp2);
+            double minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+            for (int k = 0; k <= 4000; k++) {
+                Reference::Vec p = Reference::BezierPoint(k / 4000.0, reference[i], cp1, cp2, reference[(i + 1) % knots.size()]);
+                minX = std::min(minX, p.x); minY = std::min(minY, p.y);
+                maxX = std::max(maxX, p.x); maxY = std::max(maxY, p.y);
+            }
+
+            BoundingBox box = curve.GetSegmentBounds(i);
+            double error = std::max<double>({ std::fabs(box.Min.x - minX), std::fabs(box.Min.y - minY), std::fabs(box.Max.x - maxX), std::fabs(box.Max.y - maxY) });
+            CHECK(error <= 1e-2, "trial %d, segment %zu: box (%g,%g)-(%g,%g), sampled (%g,%g)-(%g,%g)", trial, i, box.Min.x, box.Min.y, box.Max.x, box.Max.y, minX, minY, maxX, maxY);
+            expected.Add(box);
+        }
+
+        BoundingBox bounds = curve.GetBounds();
+        CHECK(bounds.IsEmpty() == expected.IsEmpty() && (bounds.IsEmpty() || (bounds.Min.x == expected.Min.x && bounds.Min.y == expected.Min.y &&
+            bounds.Max.x == expected.Max.x && bounds.Max.y == expected.Max.y)), "trial %d: curve bounds differ from the union of segment bounds", trial);
+    }
+    CHECK(DraggableBezierCurve().GetBounds().IsEmpty(), "empty curve has non-empty bounds");
+    CHECK(DraggableBezierCurve().GetSegmentBounds(0).IsEmpty(), "missing segment has non-empty bounds");
+}
+
+/**
+ * Проверяет ограничивающие прямоугольники сегментов с почти вырожденной производной: старший коэффициент
+ * производной мал по сравнению с остальными, и её корни нельзя находить по школьной формуле без потери точности.
+ * Среди них сегмент с координатами x контрольных точек 0, -50, -50, eps, у которого минимум x близок к -37.5.
+ */
+static void TestBoundsNearDegenerate() {
+    Random random(11);
+    for (int trial = 0; trial < 4000; trial++) {
+        float eps = std::ldexp((float)random.Integer(1, 1000), -random.Integer(10, 40)) * (random.Integer(0, 1) ? 1.0f : -1.0f);
+        float v[4];
+        if (trial == 0) eps = 1.1e-6f;
+        if (trial < 4) {
+            float probe[4] = { 0.0f, -50.0f, -50.0f, trial < 2 ? eps : 2e-6f * (trial - 1) };
+            std::copy(probe, probe + 4, v);
+        }
+        else {
+            for (int k = 0; k < 3; k++) v[k] = (float)random.Integer(-400, 400);
+            // Четвёртая координата подбирается так, что старший коэффициент производной равен eps.
+            v[3] = v[0] - 3.0f * v[1] + 3.0f * v[2] + eps;
+        }
+        ImVec2 p[4];
+        for (int k = 0; k < 4; k++) p[k] = ImVec2(v[k], (float)random.Integer(-400, 400));
+
+        double minX = INFINITY, maxX = -INFINITY;
+        for (int k = 0; k <= 20000; k++) {
+            Reference::Vec point = Reference::BezierPoint(k / 20000.0, { p[0].x, p[0].y }, { p[1].x, p[1].y }, { p[2].x, p[2].y }, { p[3].x, p[3].y });
+            minX = std::min(minX, point.x);
+            maxX = std::max(maxX, point.x);
+        }
+
+        BoundingBox box = BezierGeometry::BezierBounds(p[0], p[1], p[2], p[3]);
+        double slack = 1e-4 * (1.0 + std::max(std::fabs(minX), std::fabs(maxX)));
+        CHECK(box.Min.x <= minX + slack && box.Max.x >= maxX - slack && box.Min.x >= minX - 1e-2 && box.Max.x <= maxX + 1e-2,
+            "trial %d: x %g %g %g %g gives box x %g..%g, sampled %g..%g", trial, v[0], v[1], v[2], v[3], box.Min.x, box.Max.x, minX, maxX);
+    }
+}
+
+/**
+ * Сравнивает площадь и центр масс замкнутых кривых с многоугольником по плотной выборке,
+ * а IsPointInside - с числом оборотов ломаной Flatten вокруг случайных точек.
+ */
+static void TestRegion() {
+    Random random(9);
+    int inside = 0, outside = 0;
+    for (int trial = 0; trial < 500; trial++) {
+        bool closed = trial % 4 != 0;
+        std::vector<ImVec2> knots;
+        for (int i = random.Integer(1, 10); i > 0; i--) knots.push_back(random.Point(0, 800));
+        DraggableBezierCurve curve = CurveFromKnots(knots, closed);
+        std::vector<Reference::Vec> reference = ToReference(knots);
+
+        if (!closed || knots.size() < 2) {
+            CHECK(curve.GetArea() == 0.0f, "trial %d: curve without a region has area %g", trial, curve.GetArea());
+            CHECK(!curve.IsPointInside(random.Point(0, 800)), "trial %d: point inside a curve without a region", trial);
+            continue;
+        }
+
+        Reference::Vec centroid;
+        double area = Reference::PolygonArea(Reference::DenseSample(reference, 2000), &centroid);
+        CHECK(std::fabs(curve.GetArea() - std::fabs(area)) <= 1e-3 * std::fabs(area) + 1e-2, "trial %d: area %g, expected %g", trial, curve.GetArea(), std::fabs(area));
+        if (std::fabs(area) > 100.0) {
+            // У самопересекающихся кривых площади частей почти взаимно уничтожаются, и центр масс уходит далеко от кривой,
+            // поэтому погрешность берётся относительно его координат.
+            ImVec2 actual = curve.GetCentroid();
+            double error = 1e-2 + 1e-4 * (std::fabs(centroid.x) + std::fabs(centroid.y));
+            CHECK(std::fabs(actual.x - centroid.x) <= error && std::fabs(actual.y - centroid.y) <= error,
+                "trial %d: centroid (%g,%g), expected (%g,%g)", trial, actual.x, actual.y, centroid.x, centroid.y);
+        }
+
+        std::vector<Reference::Vec> polygon = Reference::Flatten(reference, true);
+        for (int k = 0; k < 200; k++) {
+            ImVec2 point(random.Real(-50.0f, 850.0f), random.Real(-50.0f, 850.0f));
+            int winding = Reference::WindingNumber({ point.x, point.y }, polygon, 1e-2);
+            if (winding == INT_MIN) continue;
+            (winding != 0 ? inside : outside)++;
+            CHECK(curve.IsPointInside(point) == (winding != 0), "trial %d: (%g,%g) has winding number %d", trial, point.x, point.y, winding);
+        }
+    }
+    CHECK(inside > 10000 && outside > 10000, "only %d inside and %d outside points", inside, outside);
+}
+
+/**
+ * Строит залитую замкнутую кривую-окружность с невидимой обводкой, чтобы в списке отрисовки была только заливка.
+ * @param count Число точек, ломаная заливки содержит в 20 раз больше вершин.
+ * @param fillColor Цвет заливки.
+ */
+static DraggableBezierCurve FilledCircle(int count, ImU32 fillColor) {
+    std::vector<ImVec2> knots;
+    for (int i = 0; i < count; i++) {
+        float angle = 6.2831853f * i / count;
+        knots.push_back(ImVec2(4000.0f + 3000.0f * std::cos(angle), 4000.0f + 3000.0f * std::sin(angle)));
+    }
+    DraggableBezierCurve curve = CurveFromKnots(knots, true);
+    curve.SetColor(IM_COL32(0, 0, 0, 0));
+    curve.SetFilled(true);
+    curve.SetFillColor(fillColor);
+    return curve;
+}
+
+/**
+ * Заливает кривые, ломаная которых не адресуется 16-битными индексами целиком, в список отрисовки с флагом
+ * ImDrawListFlags_AllowVtxOffset и без него, и восстанавливает треугольники по командам списка: индексы должны
+ * указывать на записанные вершины одной заливки. С флагом площадь треугольников совпадает с площадью кривых,
+ * без него заливка, начатая при свободных индексах, выводится целиком, а следующая - не больше своей площади.
+ */
+static void TestFillVertexLimit() {
+    const ImU32 first = IM_COL32(255, 0, 0, 96), second = IM_COL32(0, 255, 0, 96);
+    DraggableBezierCurve medium = FilledCircle(3000, first), large = FilledCircle(3400, second);
+    double mediumArea = medium.GetArea(), largeArea = large.GetArea();
+
+    for (int allow = 0; allow < 2; allow++) {
+        ImDrawListSharedData shared;
+        shared.InitialFlags = allow ? ImDrawListFlags_AllowVtxOffset : ImDrawListFlags_None;
+        ImDrawList draw_list(&shared);
+        draw_list._ResetForNewFrame();
+        draw_list.PushClipRectFullScreen();
+        ImGui::ZoneMapper zones;
+        (allow ? large : medium).Draw(&draw_list, zones);
+        large.Draw(&draw_list, zones);
+
+        std::map<ImU32, double> areas;
+        bool valid = true;
+        for (int c = 0; c < draw_list.CmdBuffer.Size && valid; c++) {
+            const ImDrawCmd& cmd = draw_list.CmdBuffer[c];
+            for (unsigned int e = 0; e + 3 <= cmd.ElemCount && valid; e += 3) {
+                const ImDrawVert* vertices[3];
+                for (int k = 0; k < 3; k++) {
+                    unsigned int index = cmd.VtxOffset + draw_list.IdxBuffer[(int)(cmd.IdxOffset + e + k)];
+                    valid = index < (unsigned int)draw_list.VtxBuffer.Size;
+                    if (!valid) break;
+                    vertices[k] = &draw_list.VtxBuffer[(int)index];
+                }
+                if (!valid) break;
+                valid = vertices[0]->col == vertices[1]->col && vertices[1]->col == vertices[2]->col;
+                ImVec2 a = vertices[0]->pos, b = vertices[1]->pos, c = vertices[2]->pos;
+                areas[vertices[0]->col] += std::fabs(((double)b.x - a.x) * ((double)c.y - a.y) - ((double)b.y - a.y) * ((double)c.x - a.x)) * 0.5;
+            }
+        }
+        CHECK(valid, "allow %d: a fill index points outside the vertices or across fills", allow);
+        if (!valid) continue;
+
+        if (allow) {
+            CHECK(std::fabs(areas[second] - 2.0 * largeArea) <= 1e-3 * largeArea, "allow 1: filled %g instead of %g", areas[second], 2.0 * largeArea);
+        }
+        else {
+            CHECK(std::fabs(areas[first] - mediumArea) <= 1e-3 * mediumArea, "allow 0: first fill covers %g instead of %g", areas[first], mediumArea);
+            CHECK(areas[second] <= largeArea * (1.0 + 1e-3), "allow 0: second fill covers %g, more than %g", areas[second], largeArea);
+            CHECK(draw_list.VtxBuffer.Size <= (1 << 16), "allow 0: %d vertices do not fit 16-bit indices", draw_list.VtxBuffer.Size);
+        }
+    }
+}
+
+/**
+ * Триангулирует невыпуклые простые многоугольники обеих ориентаций: звёздчатые со случайными радиусами
+ * и ломаные Flatten звёздчатых замкнутых кривых без самопересечений. Треугольников должно быть n - 2, все той же ориентации,
+ * что и многоугольник, а сумма их площадей должна совпадать с площадью многоугольника.
+ */
+static void TestTriangulate() {
+    Random random(10);
+    std::vector<unsigned int> triangles;
+    int curves = 0;
+    for (int trial = 0; trial < 1000; trial++) {
+        bool curve = trial % 2;
+        int count = random.Integer(3, curve ? 40 : 400);
+        std::vector<ImVec2> polygon;
+        for (int i = 0; i < count; i++) {
+            float angle = 6.2831853f * i / count, radius = curve ? random.Real(150.0f, 350.0f) : random.Real(20.0f, 350.0f);
+            polygon.push_back(ImVec2(400.0f + radius * std::cos(angle), 400.0f + radius * std::sin(angle)));
+        }
+        if (curve) {
+            std::vector<ImVec2> knots = polygon, controls;
+            BezierGeometry::ControlPoints(knots, true, controls);
+            BezierGeometry::Flatten(knots, controls, true, polygon);
+            BezierGeometry::IntersectionIndex index;
+            index.Build(polygon, polygon.size(), true);
+            if (index.IsIntersecting()) continue;
+            curves++;
+        }
+        if (trial % 4 >= 2) std::reverse(polygon.begin(), polygon.end());
+
+        std::vector<Reference::Vec> reference = ToReference(polygon);
+        double area = Reference::PolygonArea(reference);
+        BezierGeometry::Triangulate(polygon, triangles);
+        CHECK(triangles.size() == 3 * (polygon.size() - 2), "trial %d: %zu triangles for %zu vertices", trial, triangles.size() / 3, polygon.size());
+
+        double sum = 0.0, reversed = 0.0;
+        bool indices = true;
+        for (size_t t = 0; indices && t + 2 < triangles.size(); t += 3) {
+            indices = triangles[t] < polygon.size() && triangles[t + 1] < polygon.size() && triangles[t + 2] < polygon.size();
+            if (!indices) break;
+            double triangle = Reference::PolygonArea({ reference[triangles[t]], reference[triangles[t + 1]], reference[triangles[t + 2]] });
+            if (triangle * area < 0.0) reversed = std::max(reversed, std::fabs(triangle));
+            sum += std::fabs(triangle);
+        }
+        CHECK(indices, "trial %d: vertex index out of range", trial);
+        CHECK(reversed <= 1e-2, "trial %d: triangle of area %g has the opposite orientation", trial, reversed);
+        CHECK(std::fabs(sum - std::fabs(area)) <= 1e-4 * std::fabs(area), "trial %d: triangles cover %g, polygon area %g", trial, sum, std::fabs(area));
+    }
+    CHECK(curves > 200, "only %d of 500 star curves had no self-intersections", curves);
+}
+
+/**
+ * Проверяет, что присваивание копирует все свойства кривой, включая способ построения обводки и заливку.
+ */
+static void TestAssignment() {
+    DraggableBezierCurve source = CurveFromKnots({ ImVec2(10, 10), ImVec2(200, 40), ImVec2(120, 300) }, true);
+    source.SetColor(IM_COL32(1, 2, 3, 4));
+    source.SetThickness(7.0f);
+    source.SetFilled(true);
+    source.SetFillColor(IM_COL32(5, 6, 7, 8));
+    source.SetBatchedStroke(false);
+
+    DraggableBezierCurve target;
+    target = source;
+    CHECK(target.Serialize() == source.Serialize(), "assignment changed %s into %s", source.Serialize().c_str(), target.Serialize().c_str());
+    CHECK(*target.GetFilled() && *target.GetFillColor() == IM_COL32(5, 6, 7, 8), "assignment lost the fill");
+    CHECK(!*target.GetBatchedStroke(), "assignment lost the stroke mode");
+}
+
+/**
+ * Формирует строку из результата эталонного разбора в формате Serialize.
+ */
+static std::string Format(const Reference::ParsedCurve& parsed) {
+    std::ostringstream stream;
+    stream << (parsed.closed != 0) << "," << parsed.thickness << "," << static_cast<ImU32>(parsed.color);
+    for (size_t i = 0; i < parsed.colors.size(); i++)
+        stream << "," << parsed.numbers[3 * i] << "," << parsed.numbers[3 * i + 1] << "," << parsed.numbers[3 * i + 2] << "," << static_cast<ImU32>(parsed.colors[i]);
+    return stream.str();
+}
+
+/**
+ * Проверяет, что Serialize и TryDeserialize взаимно обратны, а повреждённые строки разбираются так же, как эталонным разбором.
+ */
+static void TestDeserialize() {
+    Random random(4);
+    const std::string alphabet = "0123456789.,,,-+eE \t\rxn";
+
+    for (int trial = 0; trial < 20000; trial++) {
+        std::ostringstream stream;
+        stream << random.Integer(0, 1) << "," << random.Integer(1, 40) * 0.25f << "," << (ImU32)random.engine();
+        for (int i = random.Integer(0, 8); i > 0; i--)
+            stream << "," << random.Integer(-4000, 4000) * 0.25f << "," << random.Integer(-4000, 4000) * 0.25f << "," << random.Integer(1, 40) * 0.5f << "," << (ImU32)random.engine();
+        std::string data = stream.str();
+
+        DraggableBezierCurve curve;
+        CHECK(DraggableBezierCurve::TryDeserialize(data, curve), "valid input rejected: %s", data.c_str());
+        CHECK(curve.Serialize() == data, "round trip changed %s into %s", data.c_str(), curve.Serialize().c_str());
+
+        for (int mutation = random.Integer(1, 3); mutation > 0; mutation--) {
+            size_t position = random.Integer(0, (int)data.size());
+            switch (random.Integer(0, 3)) {
+            case 0: if (position < data.size()) data.erase(position, 1); break;
+            case 1: data.insert(data.begin() + position, alphabet[random.Integer(0, (int)alphabet.size() - 1)]); break;
+            case 2: data.resize(position); break;
+            default: data.insert(data.begin() + position, '\0'); break;
+            }
+        }
+
+        Reference::ParsedCurve expected = Reference::Parse(data);
+        bool valid = DraggableBezierCurve::TryDeserialize(data, curve);
+        CHECK(valid == expected.valid, "validity of \"%s\": expected %d", data.c_str(), expected.valid);
+        if (valid && expected.valid) CHECK(curve.Serialize() == Format(expected), "\"%s\" parsed as %s", data.c_str(), curve.Serialize().c_str());
+        if (!valid) CHECK(curve.Serialize() == DraggableBezierCurve().Serialize(), "rejected \"%s\" left %s", data.c_str(), curve.Serialize().c_str());
+    }
+
+    for (const char* data : { "", "1", "1,2", "1,2,", "1,2,3,4", "1,2,3,4,5,6", "a,b,c", ",,,", "1,nan,3", "1,2,3,inf,0,5,0", "1,2,3,1e40,0,5,0" }) {
+        DraggableBezierCurve curve;
+        CHECK(!DraggableBezierCurve::TryDeserialize(data, curve), "malformed \"%s\" accepted", data);
+        CHECK(DraggableBezierCurve::Deserialize(data).Serialize() == DraggableBezierCurve().Serialize(), "malformed \"%s\" did not give an empty curve", data);
+    }
+}
+
+/**
+ * main() - функция, с которой начинается выполнение программы
+ * @brief Точка входа
+ * @return 0, если все проверки пройдены, иначе 1
+ */
+int main() {
+    TestSegmentsIntersect();
+    TestIsSelfIntersecting();
+    TestIncrementalIntersections();
+    TestAddPoint();
+    TestSimplify();
+    TestStroke();
+    TestBounds();
+    TestBoundsNearDegenerate();
+    TestRegion();
+    TestTriangulate();
+    TestFillVertexLimit();
+    TestAssignment();
+    TestDeserialize();
+
+    printf("%s: %d failed checks\n", testFailures ? "FAILED" : "PASSED", testFailures);
+    return testFailures ? 1 : 0;
+}
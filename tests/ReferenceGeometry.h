@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+#include <climits>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file ReferenceGeometry.h
+ * Файл, содержащий медленные эталонные реализации геометрических функций и разбора строки кривой,
+ * с которыми тесты сравнивают реализации библиотеки
+ * @brief Эталонные реализации
+ */
+
+namespace Reference {
+
+    /**
+     * @brief Точка с координатами двойной точности.
+     */
+    struct Vec {
+        double x = 0.0; ///< Координата x.
+        double y = 0.0; ///< Координата y.
+    };
+
+    static inline Vec operator+(const Vec& a, const Vec& b) { return { a.x + b.x, a.y + b.y }; }
+    static inline Vec operator-(const Vec& a, const Vec& b) { return { a.x - b.x, a.y - b.y }; }
+    static inline Vec operator*(const Vec& a, double k) { return { a.x * k, a.y * k }; }
+    static inline double Cross(const Vec& a, const Vec& b) { return a.x * b.y - a.y * b.x; }
+    static inline double Dot(const Vec& a, const Vec& b) { return a.x * b.x + a.y * b.y; }
+    static inline double Length(const Vec& a) { return std::sqrt(Dot(a, a)); }
+
+    /**
+     * Проверяет пересечение отрезков с целочисленными координатами в точной арифметике.
+     * Решает систему p1 + s * (q1 - p1) = p2 + u * (q2 - p2) в рациональных числах, параллельные и вырожденные отрезки разбираются отдельно.
+     * @return Логическое значение, указывающее, есть ли у отрезков общая точка (true) или нет (false).
+     */
+    static inline bool SegmentsIntersectExact(long long p1x, long long p1y, long long q1x, long long q1y, long long p2x, long long p2y, long long q2x, long long q2y) {
+        long long rx = q1x - p1x, ry = q1y - p1y;
+        long long sx = q2x - p2x, sy = q2y - p2y;
+        long long dx = p2x - p1x, dy = p2y - p1y;
+        long long denominator = rx * sy - ry * sx;
+
+        auto within = [](long long value, long long limit) { return limit > 0 ? (value >= 0 && value <= limit) : (value <= 0 && value >= limit); };
+
+        if (denominator != 0) return within(dx * sy - dy * sx, denominator) && within(dx * ry - dy * rx, denominator);
+
+        // Параллельные отрезки пересекаются, только если лежат на одной прямой и их проекции перекрываются.
+        auto pointOnSegment = [](long long px, long long py, long long ax, long long ay, long long bx, long long by) {
+            if ((bx - ax) * (py - ay) - (by - ay) * (px - ax) != 0) return false;
+            return std::min(ax, bx) <= px && px <= std::max(ax, bx) && std::min(ay, by) <= py && py <= std::max(ay, by);
+        };
+        return pointOnSegment(p2x, p2y, p1x, p1y, q1x, q1y) || pointOnSegment(q2x, q2y, p1x, p1y, q1x, q1y)
+            || pointOnSegment(p1x, p1y, p2x, p2y, q2x, q2y) || pointOnSegment(q1x, q1y, p2x, p2y, q2x, q2y);
+    }
+
+    /**
+     * Вычисляет расстояние от точки до отрезка.
+     */
+    static inline double PointSegmentDistance(const Vec& p, const Vec& a, const Vec& b) {
+        Vec ab = b - a;
+        double lengthSquared = Dot(ab, ab);
+        double t = lengthSquared > 0.0 ? std::clamp(Dot(p - a, ab) / lengthSquared, 0.0, 1.0) : 0.0;
+        return Length(p - (a + ab * t));
+    }
+
+    /**
+     * Вычисляет контрольные точки сегмента по правилу касательных библиотеки.
+     */
+    static inline void ControlPoints(const std::vector<Vec>& knots, bool closed, size_t i, Vec& cp1, Vec& cp2) {
+        size_t size = knots.size();
+        Vec p0 = knots[(size + i - 1) % size], p1 = knots[i], p2 = knots[(i + 1) % size], p3 = knots[(i + 2) % size];
+        if (!closed && i == 0) p0 = p1;
+        if (!closed && i == size - 2) p3 = p2;
+
+        auto normalize = [](const Vec& v) { double length = Length(v); return length > 0.0 ? v * (1.0 / length) : Vec(); };
+        cp1 = p1 + normalize(p2 - p0) * (Length(p1 - p0) / 4.0);
+        cp2 = p2 - normalize(p3 - p1) * (Length(p2 - p1) / 4.0);
+    }
+
+    /**
+     * Вычисляет точку кубической кривой Безье.
+     */
+    static inline Vec BezierPoint(double t, const Vec& p0, const Vec& p1, const Vec& p2, const Vec& p3) {
+        double u = 1.0 - t;
+        return p0 * (u * u * u) + p1 * (3 * u * u * t) + p2 * (3 * u * t * t) + p3 * (t * t * t);
+    }
+
+    /**
+     * Строит выборку кривой так же, как библиотека: по 20 точек на сегмент при t = 0, 0.05, ..., 0.95.
+     * @param segmentOf Индекс сегмента для каждой точки выборки.
+     */
+    static inline std::vector<Vec> Sample(const std::vector<Vec>& knots, bool closed, std::vector<size_t>* segmentOf = nullptr) {
+        std::vector<Vec> samples;
+        size_t size = knots.size();
+        for (size_t i = 0; size >= 2 && i < size - !closed; i++) {
+            Vec cp1, cp2;
+            ControlPoints(knots, closed, i, cp1, cp2);
+            for (int k = 0; k < 20; k++) {
+                samples.push_back(BezierPoint(k * 0.05, knots[i], cp1, cp2, knots[(i + 1) % size]));
+                if (segmentOf) segmentOf->push_back(i);
+            }
+        }
+        return samples;
+    }
+
+    /**
+     * Строит аппроксимирующую ломаную так же, как библиотека: выборка Sample и, для незамкнутой кривой, последняя точка.
+     * Звенья замкнутой кривой включают замыкающее звено от последней точки выборки к первой.
+     */
+    static inline std::vector<Vec> Flatten(const std::vector<Vec>& knots, bool closed) {
+        std::vector<Vec> polyline = Sample(knots, closed);
+        if (!closed && !knots.empty()) polyline.push_back(knots.back());
+        return polyline;
+    }
+
+    /**
+     * Строит ломаную Flatten как последовательность вершин: у замкнутой кривой в конце повторяется первая вершина.
+     */
+    static inline std::vector<Vec> Outline(const std::vector<Vec>& knots, bool closed) {
+        std::vector<Vec> polyline = Flatten(knots, closed);
+        if (closed && !polyline.empty()) polyline.push_back(polyline.front());
+        return polyline;
+    }
+
+    /**
+     * Вычисляет расстояние от точки до ломаной перебором всех звеньев.
+     */
+    static inline double DistanceToPolyline(const Vec& p, const std::vector<Vec>& polyline) {
+        if (polyline.size() == 1) return Length(p - polyline[0]);
+        double distance = INFINITY;
+        for (size_t i = 0; i + 1 < polyline.size(); i++) distance = std::min(distance, PointSegmentDistance(p, polyline[i], polyline[i + 1]));
+        return distance;
+    }
+
+    /**
+     * Вычисляет наибольшее расстояние от вершин ломаной from до ломаной to.
+     */
+    static inline double Deviation(const std::vector<Vec>& from, const std::vector<Vec>& to) {
+        double deviation = 0.0;
+        for (const Vec& p : from) deviation = std::max(deviation, DistanceToPolyline(p, to));
+        return deviation;
+    }
+
+    /**
+     * Строит плотную выборку замкнутой кривой: count точек на сегмент.
+     */
+    static inline std::vector<Vec> DenseSample(const std::vector<Vec>& knots, int count) {
+        std::vector<Vec> polygon;
+        for (size_t i = 0; i < knots.size(); i++) {
+            Vec cp1, cp2;
+            ControlPoints(knots, true, i, cp1, cp2);
+            for (int k = 0; k < count; k++) polygon.push_back(BezierPoint((double)k / count, knots[i], cp1, cp2, knots[(i + 1) % knots.size()]));
+        }
+        return polygon;
+    }
+
+    /**
+     * Вычисляет ориентированную площадь и центр масс многоугольника по формуле шнурования.
+     */
+    static inline double PolygonArea(const std::vector<Vec>& polygon, Vec* centroid = nullptr) {
+        double area = 0.0, cx = 0.0, cy = 0.0;
+        for (size_t i = 0; i < polygon.size(); i++) {
+            const Vec &a = polygon[i], &b = polygon[(i + 1) % polygon.size()];
+            double cross = Cross(a, b);
+            area += cross * 0.5;
+            cx += (a.x + b.x) * cross / 6.0;
+            cy += (a.y + b.y) * cross / 6.0;
+        }
+        if (centroid && area != 0.0) *centroid = { cx / area, cy / area };
+        return area;
+    }
+
+    /**
+     * Вычисляет число оборотов многоугольника вокруг точки.
+     * @param boundary Расстояние от точки до контура, при котором ответ считается зависящим от погрешности.
+     * @return Число оборотов или INT_MIN, если точка ближе boundary к контуру.
+     */
+    static inline int WindingNumber(const Vec& p, const std::vector<Vec>& polygon, double boundary) {
+        int winding = 0;
+        for (size_t i = 0; i < polygon.size(); i++) {
+            const Vec &a = polygon[i], &b = polygon[(i + 1) % polygon.size()];
+            if (PointSegmentDistance(p, a, b) <= boundary) return INT_MIN;
+            double side = Cross(b - a, p - a);
+            if (a.y <= p.y && b.y > p.y && side > 0.0) winding++;
+            else if (b.y <= p.y && a.y > p.y && side < 0.0) winding--;
+        }
+        return winding;
+    }
+
+    /**
+     * @brief Результат эталонной проверки с запасом на погрешность.
+     */
+    enum class Verdict { False, True, Ambiguous };
+
+    /**
+     * Проверяет самопересечение перебором всех пар звеньев выборки.
+     * Ответ считается однозначным, только если пересечение трансверсально с запасом margin,
+     * либо все несмежные звенья удалены друг от друга больше чем на margin.
+     */
+    static inline Verdict SelfIntersection(const std::vector<Vec>& knots, bool closed, double margin) {
+        if (knots.size() < 3) return Verdict::False;
+        std::vector<Vec> samples = Sample(knots, closed);
+
+        bool near = false;
+        for (size_t i = 0; i + 1 < samples.size(); i++) {
+            for (size_t j = i + 2; j + 1 < samples.size(); j++) {
+                const Vec &a = samples[i], &b = samples[i + 1], &c = samples[j], &d = samples[j + 1];
+                double ab = Length(b - a), cd = Length(d - c);
+                double o1 = Cross(b - a, c - a), o2 = Cross(b - a, d - a), o3 = Cross(d - c, a - c), o4 = Cross(d - c, b - c);
+
+                if (ab > margin && cd > margin && o1 * o2 < 0 && o3 * o4 < 0 &&
+                    std::min(std::fabs(o1), std::fabs(o2)) > margin * ab && std::min(std::fabs(o3), std::fabs(o4)) > margin * cd) return Verdict::True;
+
+                double distance = (o1 * o2 <= 0 && o3 * o4 <= 0) ? 0.0 : std::min({ PointSegmentDistance(a, c, d), PointSegmentDistance(b, c, d), PointSegmentDistance(c, a, b), PointSegmentDistance(d, a, b) });
+                if (distance <= margin) near = true;
+            }
+        }
+        return near ? Verdict::Ambiguous : Verdict::False;
+    }
+
+    /**
+     * Определяет, куда AddPoint вставит новую точку.
+     * @return Индекс вставки или -1, если ответ зависит от погрешности вычислений сильнее, чем на margin.
+     */
+    static inline long long InsertIndex(const std::vector<Vec>& knots, bool closed, const Vec& point, double threshold, double margin) {
+        size_t size = knots.size();
+        if (size < 2) return (long long)size;
+
+        std::vector<size_t> segmentOf;
+        std::vector<Vec> samples = Sample(knots, closed, &segmentOf);
+
+        double best = INFINITY, runnerUp = INFINITY;
+        size_t bestSegment = 0;
+        for (size_t k = 0; k < samples.size(); k++) {
+            double distance = Length(point - samples[k]);
+            if (distance < best) {
+                best = distance;
+                bestSegment = segmentOf[k];
+            }
+        }
+        for (size_t k = 0; k < samples.size(); k++)
+            if (segmentOf[k] != bestSegment) runnerUp = std::min(runnerUp, Length(point - samples[k]));
+
+        if (std::fabs(best - threshold) <= margin) return -1;
+        if (best <= threshold) return runnerUp - best <= margin ? -1 : (long long)bestSegment + 1;
+
+        double front = Length(point - knots.front()), back = Length(point - knots.back());
+        if (std::fabs(front - back) <= margin) return -1;
+        return front < back ? 0 : (long long)size;
+    }
+
+    /**
+     * @brief Результат эталонного разбора строки кривой.
+     */
+    struct ParsedCurve {
+        bool valid = false; ///< Корректность данных.
+        unsigned long closed = 0; ///< Поле замкнутости.
+        float thickness = 0.0f; ///< Толщина.
+        unsigned long color = 0; ///< Цвет.
+        std::vector<float> numbers; ///< Координаты и радиусы точек, по три на точку.
+        std::vector<unsigned long> colors; ///< Цвета точек.
+    };
+
+    /**
+     * Разбирает строку кривой: делит её на поля по запятым, включая пустые, и разбирает каждое поле через std::stof и std::stoul.
+     */
+    static inline ParsedCurve Parse(const std::string& data) {
+        std::vector<std::string> fields(1);
+        for (char c : data) {
+            if (c == ',') fields.emplace_back();
+            else fields.back() += c;
+        }
+
+        ParsedCurve result;
+        if (fields.size() < 3 || (fields.size() - 3) % 4 != 0) return result;
+
+        auto trailingSpace = [](const std::string& field, size_t position) {
+            for (size_t i = position; i < field.size(); i++) if (!std::isspace((unsigned char)field[i])) return false;
+            return true;
+        };
+        auto toFloat = [&](const std::string& field, float& value) {
+            try {
+                size_t position;
+                value = std::stof(field, &position);
+                return std::isfinite(value) && trailingSpace(field, position);
+            }
+            catch (const std::exception&) { return false; }
+        };
+        auto toInteger = [&](const std::string& field, unsigned long& value) {
+            try {
+                size_t position;
+                value = std::stoul(field, &position);
+                return trailingSpace(field, position);
+            }
+            catch (const std::exception&) { return false; }
+        };
+
+        if (!toInteger(fields[0], result.closed) || !toFloat(fields[1], result.thickness) || !toInteger(fields[2], result.color)) return result;
+        for (size_t i = 3; i < fields.size(); i += 4) {
+            float x, y, radius;
+            unsigned long color;
+            if (!toFloat(fields[i], x) || !toFloat(fields[i + 1], y) || !toFloat(fields[i + 2], radius) || !toInteger(fields[i + 3], color)) return result;
+            result.numbers.insert(result.numbers.end(), { x, y, radius });
+            result.colors.push_back(color);
+        }
+
+        result.valid = true;
+        return result;
+    }
+
+}
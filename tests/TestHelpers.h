@@ -0,0 +1,62 @@
+#pragma once
+#define IMGUI_DEFINE_MATH_OPERATORS
+
+#include <imgui.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include "DraggableBezierCurve.h"
+
+/**
+ * @file TestHelpers.h
+ * Файл, содержащий общие для тестов проверки и преобразования
+ * @brief Вспомогательные функции тестов
+ */
+
+/**
+ * Число проваленных проверок в текущей программе тестов.
+ */
+static int testFailures = 0;
+
+/**
+ * Проверяет условие и при его нарушении печатает место проверки и пояснение в формате printf.
+ */
+#define CHECK(condition, ...) do { \
+        if (!(condition)) { \
+            testFailures++; \
+            printf("%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #condition); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+/**
+ * Извлекает положения точек кривой из её сериализованного представления.
+ * @param curve Кривая.
+ * @return Положения точек кривой в порядке их следования.
+ */
+static inline std::vector<ImVec2> CurveKnots(const ImGui::DraggableBezierCurve& curve) {
+    std::vector<float> values;
+    std::istringstream stream(curve.Serialize());
+    std::string field;
+    while (std::getline(stream, field, ',')) values.push_back(std::stof(field));
+
+    std::vector<ImVec2> knots;
+    for (size_t i = 3; i + 3 < values.size(); i += 4) knots.push_back(ImVec2(values[i], values[i + 1]));
+    return knots;
+}
+
+/**
+ * Строит кривую по положениям точек через сериализованное представление.
+ * @param knots Положения точек.
+ * @param closed Замкнутость кривой.
+ * @return Кривая с заданными точками.
+ */
+static inline ImGui::DraggableBezierCurve CurveFromKnots(const std::vector<ImVec2>& knots, bool closed) {
+    std::ostringstream stream;
+    stream << closed << ",2," << IM_COL32(255, 0, 0, 255);
+    for (const ImVec2& knot : knots) stream << "," << knot.x << "," << knot.y << ",5," << IM_COL32(255, 0, 0, 255);
+    return ImGui::DraggableBezierCurve::Deserialize(stream.str());
+}
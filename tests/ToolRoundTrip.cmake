@@ -0,0 +1,36 @@
+# Converts a text scene to binary and back with the batch tool and checks that the text is unchanged,
+# then runs every stage over it on several threads with tiny chunks and checks that bad options and
+# an unwritable report are rejected.
+# Usage: cmake -DTOOL=<tool> -DINPUT=<scene.txt> -DWORK=<directory> -P ToolRoundTrip.cmake
+
+function(run_tool)
+    execute_process(COMMAND ${TOOL} ${ARGN} RESULT_VARIABLE result ERROR_VARIABLE log)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${TOOL} ${ARGN} failed with ${result}:\n${log}")
+    endif()
+endfunction()
+
+run_tool(--to binary ${INPUT} ${WORK}/roundtrip.bin)
+run_tool(--to text ${WORK}/roundtrip.bin ${WORK}/roundtrip.txt)
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${INPUT} ${WORK}/roundtrip.txt RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Text -> binary -> text changed ${INPUT}")
+endif()
+
+run_tool(--stages validate,simplify,intersect,bounds --threads 4 --chunk 3 --report ${WORK}/report.csv ${WORK}/roundtrip.bin ${WORK}/simplified.txt)
+
+# Malformed option values must be rejected with a usage error instead of being read as 0 or a huge count.
+foreach(option IN ITEMS "--tolerance;nan" "--tolerance;-1" "--tolerance;1px" "--threads;-1" "--threads;100000" "--threads;4x" "--chunk;0" "--chunk;many")
+    execute_process(COMMAND ${TOOL} ${option} ${INPUT} ${WORK}/rejected.txt RESULT_VARIABLE result OUTPUT_QUIET ERROR_QUIET)
+    if(NOT result EQUAL 1)
+        message(FATAL_ERROR "${TOOL} ${option} returned ${result} instead of a usage error")
+    endif()
+endforeach()
+
+# A report that cannot be written must fail the run.
+if(EXISTS /dev/full)
+    execute_process(COMMAND ${TOOL} --report /dev/full ${INPUT} ${WORK}/unreported.txt RESULT_VARIABLE result OUTPUT_QUIET ERROR_QUIET)
+    if(NOT result EQUAL 1)
+        message(FATAL_ERROR "${TOOL} --report /dev/full returned ${result}")
+    endif()
+endif()
@@ -0,0 +1,189 @@
+#include "TestHelpers.h"
+
+#include <imgui_internal.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+/**
+ * @file ZoneMapperThreadsTest.cpp
+ * Файл, содержащий тест построения списков отрисовки для нескольких холстов в нескольких потоках одновременно
+ * @brief Тест потокобезопасности зон
+ */
+
+/**
+ * @brief Содержимое списка отрисовки одного холста.
+ */
+struct CanvasResult {
+    std::vector<ImDrawVert> vertices; ///< Вершины последнего повтора.
+    std::vector<ImDrawIdx> indices; ///< Индексы последнего повтора.
+    std::vector<uint64_t> repeatHashes; ///< Хэши вершин и индексов каждого повтора.
+    int zoneMismatches = 0; ///< Число случаев, когда статический интерфейс ZoneMapper вернул не ту зону, которую открыл поток.
+    int strayVertices = 0; ///< Число вершин за пределами кривых холста, сдвинутых в открытые потоком зоны.
+};
+
+/**
+ * Размер холста.
+ */
+static const float canvasSize = 256.0f;
+/**
+ * Наибольшее удаление вершины от кривой: ImGui удлиняет острый стык линии толщиной 2 со сглаживанием
+ * не больше чем в 10 раз, до 15 пикселей, что перекрывает и радиус точек 5.
+ */
+static const float strayMargin = 16.0f;
+
+/**
+ * Строит кривые холста: по три кривые, одна из них замкнутая и залитая.
+ * @param canvas Номер холста.
+ * @return Кривые холста.
+ */
+static std::vector<ImGui::DraggableBezierCurve> CanvasCurves(int canvas) {
+    std::vector<ImGui::DraggableBezierCurve> curves;
+    for (int c = 0; c < 3; c++) {
+        std::vector<ImVec2> knots;
+        for (int i = 0; i < 6 + c; i++) knots.push_back(ImVec2((float)((canvas * 37 + i * 53 + c * 11) % 256), (float)((canvas * 17 + i * 91 + c * 29) % 256)));
+
+        ImGui::DraggableBezierCurve curve = CurveFromKnots(knots, c == 2);
+        curve.SetFilled(c == 2);
+        curves.push_back(curve);
+    }
+    return curves;
+}
+
+/**
+ * Вычисляет хэш FNV-1a содержимого списка отрисовки.
+ * @param drawList Список отрисовки.
+ * @return Хэш вершин и индексов.
+ */
+static uint64_t HashDrawList(const ImDrawList& drawList) {
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&](const void* data, size_t size) {
+        for (size_t i = 0; i < size; i++) hash = (hash ^ ((const unsigned char*)data)[i]) * 1099511628211ull;
+    };
+    add(drawList.VtxBuffer.begin(), drawList.VtxBuffer.Size * sizeof(ImDrawVert));
+    add(drawList.IdxBuffer.begin(), drawList.IdxBuffer.Size * sizeof(ImDrawIdx));
+    return hash;
+}
+
+/**
+ * Строит список отрисовки холста в зоне текущего экземпляра ZoneMapper вызывающего потока.
+ * На каждом повторе кривые рисуются в зоне холста и во вложенной зоне со своим для повтора смещением,
+ * а положение зон, видимое через статический интерфейс, и вершины списка сверяются с зонами, открытыми этим потоком.
+ * @param shared Общие данные списка отрисовки, принадлежащие вызывающему потоку.
+ * @param canvas Номер холста.
+ * @return Содержимое списка отрисовки.
+ */
+static CanvasResult BuildCanvas(ImDrawListSharedData* shared, int canvas) {
+    ImDrawList draw_list(shared);
+    std::vector<ImGui::DraggableBezierCurve> curves = CanvasCurves(canvas);
+    ImGui::BoundingBox bounds;
+    for (auto& curve : curves) bounds.Add(curve.GetBounds());
+
+    CanvasResult result;
+    ImGui::ZoneMapper& zones = ImGui::ZoneMapper::Current();
+    const ImVec2 origin(canvasSize * (canvas % 4), canvasSize * (canvas / 4));
+    const ImVec2 size(canvasSize, canvasSize);
+    auto expectZone = [&](const ImVec2& pos, const ImVec2& zoneSize) {
+        ImVec2 actualPos = ImGui::ZoneMapper::GetZonePos(), actualSize = ImGui::ZoneMapper::GetZoneSize();
+        if (actualPos.x != pos.x || actualPos.y != pos.y || actualSize.x != zoneSize.x || actualSize.y != zoneSize.y) result.zoneMismatches++;
+    };
+
+    zones.Begin(origin, size);
+    for (int repeat = 0; repeat < 50; repeat++) {
+        draw_list._ResetForNewFrame();
+        draw_list.PushClipRectFullScreen();
+        expectZone(origin, size);
+        for (auto& curve : curves) curve.Draw(&draw_list, zones);
+
+        const ImVec2 inner = origin + ImVec2(8.0f * (repeat % 7), 8.0f * (repeat % 5));
+        zones.Begin(inner, size * 0.5f);
+        std::this_thread::yield();
+        expectZone(inner, size * 0.5f);
+        for (auto& curve : curves) curve.Draw(&draw_list, zones);
+        zones.End();
+        expectZone(origin, size);
+
+        auto near = [&](const ImVec2& p, const ImVec2& offset) {
+            return p.x >= bounds.Min.x + offset.x - strayMargin && p.x <= bounds.Max.x + offset.x + strayMargin
+                && p.y >= bounds.Min.y + offset.y - strayMargin && p.y <= bounds.Max.y + offset.y + strayMargin;
+        };
+        for (const ImDrawVert& vertex : draw_list.VtxBuffer) {
+            if (!near(vertex.pos, origin) && !near(vertex.pos, inner)) result.strayVertices++;
+        }
+        result.repeatHashes.push_back(HashDrawList(draw_list));
+        std::this_thread::yield();
+    }
+    zones.End();
+    expectZone(ImVec2(0, 0), ImVec2(0, 0));
+
+    result.vertices.assign(draw_list.VtxBuffer.begin(), draw_list.VtxBuffer.end());
+    result.indices.assign(draw_list.IdxBuffer.begin(), draw_list.IdxBuffer.end());
+    return result;
+}
+
+/**
+ * main() - функция, с которой начинается выполнение программы
+ * @brief Точка входа
+ * @return 0, если все проверки пройдены, иначе 1
+ */
+int main() {
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1024, 1024);
+    io.IniFilename = nullptr;
+
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    ImGui::NewFrame();
+
+    // Общие данные списков отрисовки содержат временный буфер, в который пишет AddPolyline,
+    // поэтому у каждого потока своя копия.
+    const ImDrawListSharedData shared = *ImGui::GetDrawListSharedData();
+    const int canvases = (int)std::max(4u, std::thread::hardware_concurrency());
+
+    std::vector<CanvasResult> expected;
+    for (int canvas = 0; canvas < canvases; canvas++) {
+        ImDrawListSharedData local = shared;
+        expected.push_back(BuildCanvas(&local, canvas));
+    }
+
+    // Пока работают потоки, контекст ImGui снят, чтобы отладочный учёт выделений памяти не обращался к нему из разных потоков.
+    ImGuiContext* context = ImGui::GetCurrentContext();
+    ImGui::SetCurrentContext(nullptr);
+
+    std::vector<CanvasResult> actual(canvases);
+    std::vector<std::thread> threads;
+    std::atomic<int> ready(0);
+    for (int canvas = 0; canvas < canvases; canvas++) {
+        threads.emplace_back([&, canvas]() {
+            ImDrawListSharedData local = shared;
+            ready++;
+            while (ready.load() < canvases) std::this_thread::yield();
+            actual[canvas] = BuildCanvas(&local, canvas);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    ImGui::SetCurrentContext(context);
+
+    for (int canvas = 0; canvas < canvases; canvas++) {
+        const CanvasResult& a = actual[canvas];
+        const CanvasResult& e = expected[canvas];
+        CHECK(e.zoneMismatches == 0 && a.zoneMismatches == 0, "canvas %d saw another zone %d times alone and %d times among threads", canvas, e.zoneMismatches, a.zoneMismatches);
+        CHECK(e.strayVertices == 0 && a.strayVertices == 0, "canvas %d drew %d vertices alone and %d among threads outside its zones", canvas, e.strayVertices, a.strayVertices);
+        CHECK(a.repeatHashes == e.repeatHashes, "canvas %d draw lists differ from the single-threaded build on some repeats", canvas);
+        CHECK(!e.vertices.empty(), "canvas %d produced no vertices", canvas);
+        CHECK(a.vertices.size() == e.vertices.size() && std::memcmp(a.vertices.data(), e.vertices.data(), e.vertices.size() * sizeof(ImDrawVert)) == 0, "canvas %d vertices differ from the single-threaded build", canvas);
+        CHECK(a.indices == e.indices, "canvas %d indices differ from the single-threaded build", canvas);
+    }
+
+    ImGui::EndFrame();
+    ImGui::DestroyContext();
+
+    printf("%s: %d canvases on %d threads, %d failed checks\n", testFailures ? "FAILED" : "PASSED", canvases, canvases, testFailures);
+    return testFailures ? 1 : 0;
+}
@@ -0,0 +1,656 @@
+#include "BezierGeometry.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+/**
+ * @file main.cpp
+ * Файл, содержащий программу пакетной обработки файлов кривых без окна и контекста ImGui
+ * @brief Пакетная обработка кривых
+ *
+ * Программа читает файл кривых частями, обрабатывает части на всех ядрах и пишет результат в исходном порядке.
+ * В памяти одновременно находится не больше threads * 2 частей, поэтому размер входного файла не ограничен.
+ *
+ * Текстовый формат - одна кривая на строку в виде DraggableBezierCurve::Serialize(), как в curves.txt примера.
+ * Двоичный формат начинается с сигнатуры "BZC1", далее идут записи в порядке little-endian:
+ * uint8 замкнутость, float толщина, uint32 цвет, uint32 число точек и по каждой точке float x, float y, float радиус, uint32 цвет.
+ */
+
+using namespace ImGui;
+
+/**
+ * Сигнатура двоичного файла кривых.
+ */
+static const char binaryMagic[4] = { 'B', 'Z', 'C', '1' };
+/**
+ * Размер заголовка двоичной записи в байтах.
+ */
+static const size_t binaryHeaderSize = 13;
+/**
+ * Размер точки двоичной записи в байтах.
+ */
+static const size_t binaryKnotSize = 16;
+/**
+ * Наибольшее число точек в двоичной записи, защищающее от выделения памяти по повреждённому заголовку.
+ */
+static const uint32_t maxBinaryKnots = 1u << 24;
+/**
+ * Наибольший объём точек записи, читаемый за один раз, в байтах.
+ */
+static const size_t binaryReadPiece = 1u << 20;
+
+/**
+ * @brief Параметры запуска.
+ */
+struct Options {
+    bool validate = false; ///< Отбрасывать повреждённые и вырожденные записи вместо завершения с ошибкой.
+    bool simplify = false; ///< Упрощать кривые.
+    bool intersect = false; ///< Проверять самопересечение.
+    bool bounds = false; ///< Вычислять ограничивающие прямоугольники.
+    float tolerance = 1.0f; ///< Допуск упрощения.
+    bool binaryOutput = false; ///< Запись результата в двоичном формате.
+    bool binaryOutputSet = false; ///< Признак явно заданного формата результата.
+    unsigned int threads = 0; ///< Число рабочих потоков.
+    size_t chunkSize = 4096; ///< Число записей в части.
+    std::string input; ///< Путь к входному файлу, "-" - стандартный ввод.
+    std::string output; ///< Путь к файлу результата, "-" - стандартный вывод, пустая строка - без записи.
+    std::string report; ///< Путь к отчёту CSV, пустая строка - без отчёта.
+};
+
+/**
+ * @brief Часть входного файла.
+ */
+struct Chunk {
+    size_t first = 0; ///< Номер первой записи части во входном файле, начиная с 1.
+    std::vector<std::string> records; ///< Записи в формате входного файла.
+    size_t bytes = 0; ///< Размер части во входном файле.
+};
+
+/**
+ * @brief Итоги обработки части или всего файла.
+ */
+struct Stats {
+    size_t records = 0; ///< Прочитано записей.
+    size_t written = 0; ///< Записано кривых.
+    size_t invalid = 0; ///< Отброшено записей.
+    size_t intersecting = 0; ///< Кривых с самопересечением.
+    size_t knotsIn = 0; ///< Точек до упрощения.
+    size_t knotsOut = 0; ///< Точек после упрощения.
+    BoundingBox bounds; ///< Ограничивающий прямоугольник всех кривых.
+    double parseSeconds = 0.0; ///< Время разбора, суммарно по потокам.
+    double simplifySeconds = 0.0; ///< Время упрощения, суммарно по потокам.
+    double intersectSeconds = 0.0; ///< Время проверки самопересечения, суммарно по потокам.
+    double boundsSeconds = 0.0; ///< Время вычисления прямоугольников, суммарно по потокам.
+    double writeSeconds = 0.0; ///< Время преобразования в выходной формат, суммарно по потокам.
+
+    /**
+     * Добавляет итоги другой части.
+     * @param other Итоги части.
+     */
+    void Add(const Stats& other) {
+        records += other.records;
+        written += other.written;
+        invalid += other.invalid;
+        intersecting += other.intersecting;
+        knotsIn += other.knotsIn;
+        knotsOut += other.knotsOut;
+        bounds.Add(other.bounds);
+        parseSeconds += other.parseSeconds;
+        simplifySeconds += other.simplifySeconds;
+        intersectSeconds += other.intersectSeconds;
+        boundsSeconds += other.boundsSeconds;
+        writeSeconds += other.writeSeconds;
+    }
+};
+
+/**
+ * @brief Результат обработки части.
+ */
+struct ChunkResult {
+    std::string output; ///< Кривые в выходном формате.
+    std::string report; ///< Строки отчёта CSV.
+    std::string error; ///< Описание повреждённой записи, прервавшей обработку. Записи до неё уже обработаны.
+    Stats stats; ///< Итоги части.
+};
+
+/**
+ * Дописывает 32-битное число в порядке little-endian.
+ * @param out Буфер.
+ * @param value Число.
+ */
+static void PutU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back((char)((value >> (8 * i)) & 0xFF));
+}
+
+/**
+ * Дописывает число float в порядке little-endian.
+ * @param out Буфер.
+ * @param value Число.
+ */
+static void PutF32(std::string& out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    PutU32(out, bits);
+}
+
+/**
+ * Читает 32-битное число в порядке little-endian.
+ * @param data Указатель на четыре байта.
+ * @return Число.
+ */
+static uint32_t GetU32(const char* data) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+/**
+ * Читает число float в порядке little-endian.
+ * @param data Указатель на четыре байта.
+ * @return Число.
+ */
+static float GetF32(const char* data) {
+    uint32_t bits = GetU32(data);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Дописывает кривую в двоичном формате.
+ * @param curve Данные кривой.
+ * @param out Буфер.
+ */
+static void SerializeBinary(const BezierGeometry::CurveData& curve, std::string& out) {
+    out.push_back((char)curve.closed);
+    PutF32(out, curve.thickness);
+    PutU32(out, curve.color);
+    PutU32(out, (uint32_t)curve.knots.size());
+    for (const BezierGeometry::Knot& knot : curve.knots) {
+        PutF32(out, knot.pos.x);
+        PutF32(out, knot.pos.y);
+        PutF32(out, knot.radius);
+        PutU32(out, knot.color);
+    }
+}
+
+/**
+ * Разбирает двоичную запись кривой. Требования к числам те же, что и у текстового формата.
+ * @param record Запись целиком: заголовок и все точки.
+ * @param curve Данные кривой.
+ * @return Логическое значение, указывающее, корректна ли запись (true) или нет (false).
+ */
+static bool TryDeserializeBinary(const std::string& record, BezierGeometry::CurveData& curve) {
+    curve = BezierGeometry::CurveData();
+    if (record.size() < binaryHeaderSize) return false;
+
+    const char* data = record.data();
+    uint32_t count = GetU32(data + 9);
+    if (record.size() != binaryHeaderSize + (size_t)count * binaryKnotSize || (unsigned char)data[0] > 1) return false;
+
+    BezierGeometry::CurveData result;
+    result.closed = data[0] != 0;
+    result.thickness = GetF32(data + 1);
+    result.color = GetU32(data + 5);
+    if (!std::isfinite(result.thickness)) return false;
+
+    result.knots.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const char* knot = data + binaryHeaderSize + i * binaryKnotSize;
+        result.knots[i].pos = ImVec2(GetF32(knot), GetF32(knot + 4));
+        result.knots[i].radius = GetF32(knot + 8);
+        result.knots[i].color = GetU32(knot + 12);
+        if (!std::isfinite(result.knots[i].pos.x) || !std::isfinite(result.knots[i].pos.y) || !std::isfinite(result.knots[i].radius)) return false;
+    }
+
+    curve = std::move(result);
+    return true;
+}
+
+/**
+ * Читает очередную часть входного файла.
+ * @param in Входной поток.
+ * @param binary Формат входного файла.
+ * @param chunkSize Наибольшее число записей в части.
+ * @param chunk Часть, в которую записываются записи.
+ * @param error Описание ошибки чтения.
+ * @return Логическое значение, указывающее, прочитана ли хотя бы одна запись (true) или файл закончился (false).
+ */
+static bool ReadChunk(std::istream& in, bool binary, size_t chunkSize, Chunk& chunk, std::string& error) {
+    chunk.records.clear();
+    chunk.bytes = 0;
+    std::string record;
+    while (chunk.records.size() < chunkSize) {
+        if (!binary) {
+            if (!std::getline(in, record)) break;
+            chunk.bytes += record.size() + 1;
+            if (!record.empty() && record.back() == '\r') record.pop_back();
+            if (record.empty()) continue;
+        }
+        else {
+            record.resize(binaryHeaderSize);
+            in.read(&record[0], binaryHeaderSize);
+            if (in.gcount() == 0) break;
+            if ((size_t)in.gcount() != binaryHeaderSize) {
+                error = "truncated record header";
+                break;
+            }
+            uint32_t count = GetU32(record.data() + 9);
+            if (count > maxBinaryKnots) {
+                error = "record with " + std::to_string(count) + " points";
+                break;
+            }
+            // Точки читаются частями, и память растёт только по мере поступления данных: повреждённый заголовок
+            // в коротком файле или потоке не приводит к выделению памяти под всё заявленное число точек.
+            const size_t size = binaryHeaderSize + (size_t)count * binaryKnotSize;
+            bool truncated = false;
+            while (record.size() < size && !truncated) {
+                size_t offset = record.size();
+                size_t piece = std::min(size - offset, binaryReadPiece);
+                record.resize(offset + piece);
+                in.read(&record[offset], piece);
+                truncated = (size_t)in.gcount() != piece;
+            }
+            if (truncated) {
+                error = "truncated record";
+                break;
+            }
+        }
+        if (binary) chunk.bytes += record.size();
+        chunk.records.push_back(std::move(record));
+    }
+    return !chunk.records.empty();
+}
+
+/**
+ * Проверяет, годится ли разобранная кривая для дальнейшей обработки.
+ * @param curve Данные кривой.
+ * @return Логическое значение, указывающее, имеет ли кривая хотя бы один сегмент и неотрицательные размеры (true) или нет (false).
+ */
+static bool IsUsable(const BezierGeometry::CurveData& curve) {
+    if (curve.knots.size() < 2 || !(curve.thickness > 0.0f)) return false;
+    for (const BezierGeometry::Knot& knot : curve.knots) if (knot.radius < 0.0f) return false;
+    return true;
+}
+
+/**
+ * Обрабатывает часть входного файла всеми включёнными этапами.
+ * @param chunk Часть входного файла.
+ * @param options Параметры запуска.
+ * @param binaryInput Формат входного файла.
+ * @return Результат обработки части.
+ */
+static ChunkResult ProcessChunk(const Chunk& chunk, const Options& options, bool binaryInput) {
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    ChunkResult result;
+    Stats& stats = result.stats;
+    BezierGeometry::CurveData curve;
+    std::vector<ImVec2> knots, controls;
+    std::vector<size_t> kept;
+
+    for (size_t r = 0; r < chunk.records.size(); r++) {
+        size_t index = chunk.first + r;
+        stats.records++;
+
+        auto start = Clock::now();
+        bool valid = binaryInput ? TryDeserializeBinary(chunk.records[r], curve) : BezierGeometry::TryDeserialize(chunk.records[r], curve);
+        if (valid && options.validate) valid = IsUsable(curve);
+        stats.parseSeconds += seconds(start);
+
+        if (!valid) {
+            stats.invalid++;
+            if (!options.validate) {
+                result.error = "record " + std::to_string(index) + " is malformed";
+                return result;
+            }
+            continue;
+        }
+
+        knots.resize(curve.knots.size());
+        for (size_t i = 0; i < knots.size(); i++) knots[i] = curve.knots[i].pos;
+        stats.knotsIn += knots.size();
+
+        if (options.simplify) {
+            start = Clock::now();
+            BezierGeometry::Simplify(knots, curve.closed, options.tolerance, kept);
+            if (kept.size() != knots.size()) {
+                std::vector<BezierGeometry::Knot> simplified;
+                simplified.reserve(kept.size());
+                for (size_t i : kept) simplified.push_back(curve.knots[i]);
+                curve.knots.swap(simplified);
+
+                knots.resize(curve.knots.size());
+                for (size_t i = 0; i < knots.size(); i++) knots[i] = curve.knots[i].pos;
+            }
+            stats.simplifySeconds += seconds(start);
+        }
+        stats.knotsOut += knots.size();
+
+        bool intersecting = false;
+        if (options.intersect) {
+            start = Clock::now();
+            intersecting = BezierGeometry::IsSelfIntersecting(knots, curve.closed);
+            stats.intersecting += intersecting;
+            stats.intersectSeconds += seconds(start);
+        }
+
+        BoundingBox box;
+        if (options.bounds) {
+            start = Clock::now();
+            BezierGeometry::ControlPoints(knots, curve.closed, controls);
+            if (knots.size() == 1) box.Add(knots[0]);
+            for (size_t i = 0; i < controls.size() / 2; i++)
+                box.Add(BezierGeometry::BezierBounds(knots[i], controls[2 * i], controls[2 * i + 1], knots[(i + 1) % knots.size()]));
+            stats.bounds.Add(box);
+            stats.boundsSeconds += seconds(start);
+        }
+
+        start = Clock::now();
+        if (!options.output.empty()) {
+            if (options.binaryOutput) SerializeBinary(curve, result.output);
+            else {
+                BezierGeometry::Serialize(curve, result.output);
+                result.output.push_back('\n');
+            }
+        }
+        if (!options.report.empty()) {
+            char line[256];
+            int length = snprintf(line, sizeof(line), "%zu,%zu,", index, knots.size());
+            result.report.append(line, length);
+            if (options.intersect) result.report.append(intersecting ? "1" : "0");
+            if (options.bounds && !box.IsEmpty()) {
+                length = snprintf(line, sizeof(line), ",%g,%g,%g,%g\n", box.Min.x, box.Min.y, box.Max.x, box.Max.y);
+                result.report.append(line, length);
+            }
+            else result.report.append(",,,,\n");
+        }
+        stats.written++;
+        stats.writeSeconds += seconds(start);
+    }
+    return result;
+}
+
+/**
+ * Печатает описание параметров запуска.
+ * @param program Имя программы.
+ */
+static void PrintUsage(const char* program) {
+    fprintf(stderr,
+        "Usage: %s [options] <input> [output]\n"
+        "Streams a curve file through the selected stages. '-' reads stdin or writes stdout.\n"
+        "Text input is one curve per line as written by the example; binary input is detected by its signature.\n"
+        "\n"
+        "  --stages LIST      comma-separated stages in any order, run as validate,simplify,intersect,bounds\n"
+        "  --tolerance PX     simplification tolerance (default 1)\n"
+        "  --to text|binary   output format (default: same as input)\n"
+        "  --report FILE      write CSV: record,knots,self_intersecting,min_x,min_y,max_x,max_y\n"
+        "  --threads N        worker threads, 0 for all cores (default 0)\n"
+        "  --chunk N          records per chunk (default 4096)\n"
+        "\n"
+        "Without the validate stage a malformed record stops processing; with it, malformed records\n"
+        "and curves with fewer than two points, non-positive thickness or negative radius are dropped.\n",
+        program);
+}
+
+/**
+ * Наибольшее число рабочих потоков, принимаемое из параметров запуска.
+ */
+static const unsigned long maxThreads = 1024;
+/**
+ * Наибольшее число записей в части, принимаемое из параметров запуска.
+ */
+static const unsigned long maxChunkSize = 1ul << 24;
+
+/**
+ * Разбирает неотрицательное конечное число, занимающее значение параметра целиком.
+ * @param text Значение параметра.
+ * @param value Результат.
+ * @return Логическое значение, указывающее, корректно ли значение (true) или нет (false).
+ */
+static bool TryParseFloat(const char* text, float& value) {
+    char* parsed;
+    errno = 0;
+    value = std::strtof(text, &parsed);
+    return parsed != text && *parsed == '\0' && errno != ERANGE && std::isfinite(value) && value >= 0.0f;
+}
+
+/**
+ * Разбирает десятичное целое из заданного диапазона, занимающее значение параметра целиком.
+ * @param text Значение параметра.
+ * @param min Наименьшее допустимое значение.
+ * @param max Наибольшее допустимое значение.
+ * @param value Результат.
+ * @return Логическое значение, указывающее, корректно ли значение (true) или нет (false).
+ */
+static bool TryParseInteger(const char* text, unsigned long min, unsigned long max, unsigned long& value) {
+    // strtoul принимает знак минус и возвращает для "-1" наибольшее значение, поэтому допускаются только цифры.
+    if (!isdigit((unsigned char)*text)) return false;
+    char* parsed;
+    errno = 0;
+    value = std::strtoul(text, &parsed, 10);
+    return *parsed == '\0' && errno != ERANGE && value >= min && value <= max;
+}
+
+/**
+ * Разбирает параметры запуска.
+ * @param argc Число аргументов.
+ * @param argv Аргументы.
+ * @param options Параметры запуска.
+ * @return Логическое значение, указывающее, корректны ли параметры (true) или нет (false).
+ */
+static bool ParseOptions(int argc, char** argv, Options& options) {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+
+        if (arg == "--stages") {
+            const char* list = value();
+            if (!list) return false;
+            std::istringstream stream(list);
+            std::string stage;
+            while (std::getline(stream, stage, ',')) {
+                if (stage == "validate") options.validate = true;
+                else if (stage == "simplify") options.simplify = true;
+                else if (stage == "intersect") options.intersect = true;
+                else if (stage == "bounds") options.bounds = true;
+                else {
+                    fprintf(stderr, "Unknown stage '%s'\n", stage.c_str());
+                    return false;
+                }
+            }
+        }
+        else if (arg == "--tolerance") {
+            const char* v = value();
+            if (!v || !TryParseFloat(v, options.tolerance)) {
+                fprintf(stderr, "Invalid tolerance '%s'\n", v ? v : "");
+                return false;
+            }
+        }
+        else if (arg == "--to") {
+            const char* v = value();
+            if (!v || (strcmp(v, "text") != 0 && strcmp(v, "binary") != 0)) return false;
+            options.binaryOutput = strcmp(v, "binary") == 0;
+            options.binaryOutputSet = true;
+        }
+        else if (arg == "--report") {
+            const char* v = value();
+            if (!v) return false;
+            options.report = v;
+        }
+        else if (arg == "--threads") {
+            const char* v = value();
+            unsigned long threads;
+            if (!v || !TryParseInteger(v, 0, maxThreads, threads)) {
+                fprintf(stderr, "Invalid thread count '%s', expected 0 (all cores) to %lu\n", v ? v : "", maxThreads);
+                return false;
+            }
+            options.threads = (unsigned int)threads;
+        }
+        else if (arg == "--chunk") {
+            const char* v = value();
+            unsigned long chunkSize;
+            if (!v || !TryParseInteger(v, 1, maxChunkSize, chunkSize)) {
+                fprintf(stderr, "Invalid chunk size '%s', expected 1 to %lu\n", v ? v : "", maxChunkSize);
+                return false;
+            }
+            options.chunkSize = chunkSize;
+        }
+        else if (arg.size() > 1 && arg[0] == '-' && arg != "-") {
+            fprintf(stderr, "Unknown option '%s'\n", arg.c_str());
+            return false;
+        }
+        else positional.push_back(arg);
+    }
+
+    if (positional.empty() || positional.size() > 2) return false;
+    options.input = positional[0];
+    if (positional.size() == 2) options.output = positional[1];
+    if (options.threads == 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    return true;
+}
+
+/**
+ * main() - функция, с которой начинается выполнение программы
+ * @brief Точка входа
+ * @param argc Число аргументов.
+ * @param argv Аргументы.
+ * @return 0 при успешной обработке, 1 при ошибке параметров, ввода или вывода, 2 при повреждённой записи без этапа validate
+ */
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::ifstream inputFile;
+    std::istream* in = &std::cin;
+    if (options.input != "-") {
+        inputFile.open(options.input, std::ios::binary);
+        if (!inputFile) {
+            fprintf(stderr, "Cannot open %s\n", options.input.c_str());
+            return 1;
+        }
+        in = &inputFile;
+    }
+
+    // Текстовая запись начинается с числа, поэтому первого байта достаточно, чтобы отличить двоичный файл,
+    // и стандартный ввод не нужно перематывать.
+    bool binaryInput = in->peek() == binaryMagic[0];
+    if (binaryInput) {
+        char magic[sizeof(binaryMagic)] = {};
+        in->read(magic, sizeof(magic));
+        if (memcmp(magic, binaryMagic, sizeof(magic)) != 0) {
+            fprintf(stderr, "%s is neither a text nor a binary curve file\n", options.input.c_str());
+            return 1;
+        }
+    }
+    if (!options.binaryOutputSet) options.binaryOutput = binaryInput;
+
+    std::ofstream outputFile, reportFile;
+    std::ostream* out = nullptr;
+    if (!options.output.empty()) {
+        if (options.output == "-") out = &std::cout;
+        else {
+            outputFile.open(options.output, std::ios::binary);
+            if (!outputFile) {
+                fprintf(stderr, "Cannot create %s\n", options.output.c_str());
+                return 1;
+            }
+            out = &outputFile;
+        }
+        if (options.binaryOutput) out->write(binaryMagic, sizeof(binaryMagic));
+    }
+    if (!options.report.empty()) {
+        reportFile.open(options.report, std::ios::binary);
+        if (!reportFile) {
+            fprintf(stderr, "Cannot create %s\n", options.report.c_str());
+            return 1;
+        }
+        reportFile << "record,knots,self_intersecting,min_x,min_y,max_x,max_y\n";
+    }
+
+    // Главный поток читает части и пишет результаты в исходном порядке, рабочие потоки обрабатывают
+    // не больше 2 * threads частей одновременно, так что расход памяти не зависит от размера файла.
+    auto start = std::chrono::steady_clock::now();
+    const size_t maxInFlight = 2 * (size_t)options.threads;
+    std::deque<std::future<ChunkResult>> inFlight;
+    Stats total;
+    std::string error;
+    size_t next = 1;
+    size_t bytesIn = 0;
+    size_t bytesOut = 0;
+
+    auto finishOldest = [&]() {
+        ChunkResult result = inFlight.front().get();
+        inFlight.pop_front();
+        if (!error.empty()) return;
+        total.Add(result.stats);
+        if (out) out->write(result.output.data(), result.output.size());
+        if (!options.report.empty()) reportFile.write(result.report.data(), result.report.size());
+        bytesOut += result.output.size();
+        error = result.error;
+    };
+
+    std::string readError;
+    while (error.empty()) {
+        auto chunk = std::make_shared<Chunk>();
+        chunk->first = next;
+        if (!ReadChunk(*in, binaryInput, options.chunkSize, *chunk, readError)) break;
+        next += chunk->records.size();
+        bytesIn += chunk->bytes;
+
+        if (inFlight.size() >= maxInFlight) finishOldest();
+        inFlight.push_back(std::async(std::launch::async, [chunk, &options, binaryInput]() { return ProcessChunk(*chunk, options, binaryInput); }));
+        if (!readError.empty()) break;
+    }
+    while (!inFlight.empty()) finishOldest();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (out) out->flush();
+
+    if (!readError.empty() && error.empty()) error = "record " + std::to_string(next) + ": " + readError;
+    if (!error.empty()) fprintf(stderr, "Error: %s\n", error.c_str());
+    // Ошибка записи может проявиться только при сбросе буфера в close(), поэтому файлы проверяются после закрытия.
+    if (outputFile.is_open()) outputFile.close();
+    if (out && !*out) {
+        fprintf(stderr, "Error: cannot write %s\n", options.output.c_str());
+        return 1;
+    }
+    if (reportFile.is_open()) {
+        reportFile.close();
+        if (!reportFile) {
+            fprintf(stderr, "Error: cannot write %s\n", options.report.c_str());
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "records   %zu read, %zu written, %zu dropped\n", total.records, total.written, total.invalid);
+    if (options.simplify) fprintf(stderr, "simplify  %zu -> %zu points (x%.2f)\n", total.knotsIn, total.knotsOut, total.knotsOut ? (double)total.knotsIn / total.knotsOut : 1.0);
+    if (options.intersect) fprintf(stderr, "intersect %zu self-intersecting\n", total.intersecting);
+    if (options.bounds && !total.bounds.IsEmpty()) fprintf(stderr, "bounds    (%g, %g) - (%g, %g)\n", total.bounds.Min.x, total.bounds.Min.y, total.bounds.Max.x, total.bounds.Max.y);
+    fprintf(stderr, "cpu s     parse %.3f, simplify %.3f, intersect %.3f, bounds %.3f, write %.3f\n",
+        total.parseSeconds, total.simplifySeconds, total.intersectSeconds, total.boundsSeconds, total.writeSeconds);
+    fprintf(stderr, "time      %.3f s on %u threads, %.0f curves/s, %.0f points/s", elapsed, options.threads,
+        total.records / std::max(elapsed, 1e-9), total.knotsIn / std::max(elapsed, 1e-9));
+    fprintf(stderr, ", %.1f MB/s in", bytesIn / std::max(elapsed, 1e-9) / 1e6);
+    if (out) fprintf(stderr, ", %.1f MB/s out", bytesOut / std::max(elapsed, 1e-9) / 1e6);
+    fprintf(stderr, "\n");
+
+    if (!readError.empty()) return 1;
+    return error.empty() ? 0 : 2;
+}